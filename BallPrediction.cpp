@@ -0,0 +1,239 @@
+#include "pch.h"
+#include "BallPrediction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace
+{
+	// The integration is written once against a "lanes" type: float for single paths, Sse/Avx for batches.
+	// Every operation maps to exactly one IEEE operation in each type, so a batch lane gives the same result as the scalar path.
+
+	float Select(bool mask, float a, float b) { return mask ? a : b; }
+	bool And(bool a, bool b) { return a && b; }
+	bool Any(bool a) { return a; }
+	float Sqrt(float a) { return std::sqrt(a); }
+	float Min(float a, float b) { return (std::min)(a, b); }
+	float Max(float a, float b) { return (std::max)(a, b); }
+
+	struct Sse
+	{
+		static constexpr size_t WIDTH = 4;
+		__m128 v;
+		Sse(float f) : v(_mm_set1_ps(f)) {}
+		Sse(__m128 x) : v(x) {}
+	};
+	struct SseMask
+	{
+		__m128 m;
+	};
+
+	Sse operator+(Sse a, Sse b) { return _mm_add_ps(a.v, b.v); }
+	Sse operator-(Sse a, Sse b) { return _mm_sub_ps(a.v, b.v); }
+	Sse operator*(Sse a, Sse b) { return _mm_mul_ps(a.v, b.v); }
+	Sse operator/(Sse a, Sse b) { return _mm_div_ps(a.v, b.v); }
+	SseMask operator<(Sse a, Sse b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+	SseMask operator>(Sse a, Sse b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+	SseMask And(SseMask a, SseMask b) { return {_mm_and_ps(a.m, b.m)}; }
+	bool Any(SseMask a) { return _mm_movemask_ps(a.m) != 0; }
+	Sse Select(SseMask mask, Sse a, Sse b) { return _mm_or_ps(_mm_and_ps(mask.m, a.v), _mm_andnot_ps(mask.m, b.v)); }
+	Sse Sqrt(Sse a) { return _mm_sqrt_ps(a.v); }
+	Sse Min(Sse a, Sse b) { return _mm_min_ps(a.v, b.v); }
+	Sse Max(Sse a, Sse b) { return _mm_max_ps(a.v, b.v); }
+	Sse Load(const float* p, Sse) { return _mm_loadu_ps(p); }
+	void Store(float* p, Sse a) { _mm_storeu_ps(p, a.v); }
+
+#ifdef __AVX__
+	struct Avx
+	{
+		static constexpr size_t WIDTH = 8;
+		__m256 v;
+		Avx(float f) : v(_mm256_set1_ps(f)) {}
+		Avx(__m256 x) : v(x) {}
+	};
+	struct AvxMask
+	{
+		__m256 m;
+	};
+
+	Avx operator+(Avx a, Avx b) { return _mm256_add_ps(a.v, b.v); }
+	Avx operator-(Avx a, Avx b) { return _mm256_sub_ps(a.v, b.v); }
+	Avx operator*(Avx a, Avx b) { return _mm256_mul_ps(a.v, b.v); }
+	Avx operator/(Avx a, Avx b) { return _mm256_div_ps(a.v, b.v); }
+	AvxMask operator<(Avx a, Avx b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+	AvxMask operator>(Avx a, Avx b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+	AvxMask And(AvxMask a, AvxMask b) { return {_mm256_and_ps(a.m, b.m)}; }
+	bool Any(AvxMask a) { return _mm256_movemask_ps(a.m) != 0; }
+	Avx Select(AvxMask mask, Avx a, Avx b) { return _mm256_blendv_ps(b.v, a.v, mask.m); }
+	Avx Sqrt(Avx a) { return _mm256_sqrt_ps(a.v); }
+	Avx Min(Avx a, Avx b) { return _mm256_min_ps(a.v, b.v); }
+	Avx Max(Avx a, Avx b) { return _mm256_max_ps(a.v, b.v); }
+	Avx Load(const float* p, Avx) { return _mm256_loadu_ps(p); }
+	void Store(float* p, Avx a) { _mm256_storeu_ps(p, a.v); }
+
+	using BatchLanes = Avx;
+#else
+	using BatchLanes = Sse;
+#endif
+
+	// How much of the normal impulse the friction can use, relative to the contact's sliding speed
+	constexpr float FRICTION_RATIO_SCALE = 2.0f;
+
+	template <typename F>
+	struct Ball
+	{
+		F p[3];
+		F v[3];
+		F w[3];
+	};
+
+	// Contact with the plane whose normal is SIGN * axis AXIS, `distance` away from the ball's center
+	template <int AXIS, int SIGN, typename F>
+	void Bounce(Ball<F>& ball, const BallPhysics& physics, F distance)
+	{
+		constexpr int B = (AXIS + 1) % 3;
+		constexpr int C = (AXIS + 2) % 3;
+		constexpr float s = static_cast<float>(SIGN);
+		const float r = physics.radius;
+
+		const auto touching = distance < F(r);
+		// Most steps are in the air, skip the contact math unless some lane touches
+		if (!Any(touching))
+		{
+			return;
+		}
+		// Speed towards the plane, positive when approaching
+		const F approachSpeed = ball.v[AXIS] * -s;
+		const auto approaching = And(touching, approachSpeed > F(0.0f));
+
+		ball.p[AXIS] = Select(touching, ball.p[AXIS] + (F(r) - distance) * s, ball.p[AXIS]);
+
+		// Velocity of the contact point along the plane
+		const F slideB = ball.v[B] - ball.w[C] * (r * s);
+		const F slideC = ball.v[C] + ball.w[B] * (r * s);
+		const F slideSpeed = Sqrt(slideB * slideB + slideC * slideC);
+		const F frictionScale = Min(F(1.0f), approachSpeed / Max(slideSpeed, F(1e-4f)) * FRICTION_RATIO_SCALE) * physics.friction;
+
+		const F frictionB = frictionScale * slideB;
+		const F frictionC = frictionScale * slideC;
+		const float spin = physics.spinTransfer * r * s;
+		ball.w[B] = Select(approaching, ball.w[B] - frictionC * spin, ball.w[B]);
+		ball.w[C] = Select(approaching, ball.w[C] + frictionB * spin, ball.w[C]);
+		ball.v[B] = Select(approaching, ball.v[B] - frictionB, ball.v[B]);
+		ball.v[C] = Select(approaching, ball.v[C] - frictionC, ball.v[C]);
+		ball.v[AXIS] = Select(approaching, ball.v[AXIS] * -physics.restitution, ball.v[AXIS]);
+	}
+
+	template <typename F>
+	void ClampLength(F (&vector)[3], float maxLength)
+	{
+		const F lengthSquared = vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2];
+		const auto tooLong = lengthSquared > F(maxLength * maxLength);
+		if (!Any(tooLong))
+		{
+			return;
+		}
+		const F scale = Select(tooLong, F(maxLength) / Sqrt(lengthSquared), F(1.0f));
+		for (F& component : vector)
+		{
+			component = component * scale;
+		}
+	}
+
+	template <typename F>
+	void Step(Ball<F>& ball, const BallPhysics& physics)
+	{
+		constexpr float dt = BallPredictor::TICK;
+		const float damping = 1.0f - physics.drag * dt;
+
+		ball.v[2] = ball.v[2] + F(physics.gravity * dt);
+		for (F& component : ball.v)
+		{
+			component = component * damping;
+		}
+		ClampLength(ball.v, physics.maxSpeed);
+		ClampLength(ball.w, physics.maxAngularSpeed);
+		for (int i = 0; i < 3; ++i)
+		{
+			ball.p[i] = ball.p[i] + ball.v[i] * dt;
+		}
+
+		Bounce<2, 1>(ball, physics, ball.p[2]);
+		Bounce<2, -1>(ball, physics, F(physics.ceiling) - ball.p[2]);
+		Bounce<0, 1>(ball, physics, ball.p[0] + physics.sideWall);
+		Bounce<0, -1>(ball, physics, F(physics.sideWall) - ball.p[0]);
+		Bounce<1, 1>(ball, physics, ball.p[1] + physics.backWall);
+		Bounce<1, -1>(ball, physics, F(physics.backWall) - ball.p[1]);
+	}
+
+	template <typename F>
+	void PredictLanes(const BallPhysics& physics, std::span<const BallState> starts, size_t first, int steps, BallPathBatch& out)
+	{
+		constexpr size_t width = F::WIDTH;
+		// Transpose the starts into lanes. Lanes past the end repeat the last start, their output lands in the padding.
+		float components[9][width];
+		for (size_t lane = 0; lane < width; ++lane)
+		{
+			const BallState& state = starts[(std::min)(first + lane, starts.size() - 1)];
+			const Vec3* vectors[3] = {&state.position, &state.velocity, &state.angularVelocity};
+			for (int i = 0; i < 3; ++i)
+			{
+				components[i * 3 + 0][lane] = vectors[i]->x;
+				components[i * 3 + 1][lane] = vectors[i]->y;
+				components[i * 3 + 2][lane] = vectors[i]->z;
+			}
+		}
+
+		Ball<F> ball{
+			{Load(components[0], F(0.0f)), Load(components[1], F(0.0f)), Load(components[2], F(0.0f))},
+			{Load(components[3], F(0.0f)), Load(components[4], F(0.0f)), Load(components[5], F(0.0f))},
+			{Load(components[6], F(0.0f)), Load(components[7], F(0.0f)), Load(components[8], F(0.0f))},
+		};
+		for (int step = 0; step < steps; ++step)
+		{
+			Step(ball, physics);
+			const size_t offset = static_cast<size_t>(step) * out.stride + first;
+			Store(out.x.data() + offset, ball.p[0]);
+			Store(out.y.data() + offset, ball.p[1]);
+			Store(out.z.data() + offset, ball.p[2]);
+		}
+	}
+}
+
+BallPredictor::BallPredictor(const BallPhysics& physics) : physics_(physics)
+{
+}
+
+void BallPredictor::Predict(const BallState& start, std::span<BallState> out) const
+{
+	Ball<float> ball{
+		{start.position.x, start.position.y, start.position.z},
+		{start.velocity.x, start.velocity.y, start.velocity.z},
+		{start.angularVelocity.x, start.angularVelocity.y, start.angularVelocity.z},
+	};
+	for (BallState& state : out)
+	{
+		Step(ball, physics_);
+		state.position = {ball.p[0], ball.p[1], ball.p[2]};
+		state.velocity = {ball.v[0], ball.v[1], ball.v[2]};
+		state.angularVelocity = {ball.w[0], ball.w[1], ball.w[2]};
+	}
+}
+
+void BallPredictor::PredictBatch(std::span<const BallState> starts, int steps, BallPathBatch& out) const
+{
+	constexpr size_t width = BatchLanes::WIDTH;
+	out.count = starts.size();
+	out.steps = steps;
+	out.stride = (starts.size() + width - 1) / width * width;
+	const size_t size = out.stride * static_cast<size_t>((std::max)(steps, 0));
+	out.x.resize(size);
+	out.y.resize(size);
+	out.z.resize(size);
+
+	for (size_t first = 0; first < starts.size(); first += width)
+	{
+		PredictLanes<BatchLanes>(physics_, starts, first, steps, out);
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Ball path prediction for overlays. Doesn't depend on the SDK, so it can be built and checked outside the game;
+// fill a BallState from BallWrapper::GetLocation/GetVelocity/GetAngularVelocity.
+//
+// The arena is an axis aligned box (no rounded corners, goals or ramps). Contacts use the bounce model from RLUtilities:
+// restitution on the normal velocity, friction against the contact point's velocity, which also changes the spin.
+
+struct Vec3
+{
+	float x = 0;
+	float y = 0;
+	float z = 0;
+};
+
+struct BallState
+{
+	Vec3 position;
+	Vec3 velocity;
+	Vec3 angularVelocity;  // rad/s
+};
+
+// Unreal units and seconds. The defaults are standard soccar; mutators change gravity and ball size.
+struct BallPhysics
+{
+	float gravity = -650.0f;
+	float radius = 91.25f;
+	float drag = 0.0305f;
+	float restitution = 0.6f;
+	float friction = 0.285f;
+	float spinTransfer = 0.0003f;
+	float maxSpeed = 6000.0f;
+	float maxAngularSpeed = 6.0f;
+	// Half the arena's width and length, and the ceiling height
+	float sideWall = 4096.0f;
+	float backWall = 5120.0f;
+	float ceiling = 2044.0f;
+};
+
+// Positions of many predicted paths, stored per step: x[step * stride + path]
+struct BallPathBatch
+{
+	size_t count = 0;
+	int steps = 0;
+	size_t stride = 0;
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+
+	[[nodiscard]] Vec3 Position(size_t path, int step) const
+	{
+		const size_t i = static_cast<size_t>(step) * stride + path;
+		return {x[i], y[i], z[i]};
+	}
+};
+
+class BallPredictor
+{
+public:
+	static constexpr int TICK_RATE = 120;
+	static constexpr float TICK = 1.0f / TICK_RATE;
+	// 6 seconds
+	static constexpr int DEFAULT_STEPS = 6 * TICK_RATE;
+
+	explicit BallPredictor(const BallPhysics& physics = {});
+
+	// Fills out with the states after 1, 2, ... out.size() ticks.
+	void Predict(const BallState& start, std::span<BallState> out) const;
+
+	// Predicts one path per start, several at a time in SIMD lanes (8 with AVX, otherwise 4).
+	// The positions match what Predict gives for the same start.
+	void PredictBatch(std::span<const BallState> starts, int steps, BallPathBatch& out) const;
+
+	[[nodiscard]] const BallPhysics& Physics() const { return physics_; }
+
+private:
+	BallPhysics physics_;
+};
@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "CanvasBatch.h"
+
+#include <algorithm>
+#include <tuple>
+
+void CanvasCommands::DrawString(Vector2F position, std::string_view text, float scale, bool dropShadow)
+{
+	const auto offset = static_cast<uint32_t>(text_.size());
+	text_.append(text);
+	Add({color_, Kind::Text, dropShadow, position.X, position.Y, 0, 0, scale, offset, static_cast<uint32_t>(text.size())});
+}
+
+void CanvasCommands::Clear()
+{
+	commands_.clear();
+	text_.clear();
+	color_ = 0xFFFFFFFF;
+}
+
+void CanvasBatch::Submit(int layer, CanvasCommands commands)
+{
+	std::lock_guard lock(mutex_);
+	for (Layer& pending : pending_)
+	{
+		if (pending.id == layer)
+		{
+			pending.commands = std::move(commands);
+			return;
+		}
+	}
+	pending_.push_back({layer, std::move(commands)});
+}
+
+void CanvasBatch::ClearLayer(int layer)
+{
+	std::lock_guard lock(mutex_);
+	std::erase_if(pending_, [layer](const Layer& pending) { return pending.id == layer; });
+	pendingClears_.push_back(layer);
+}
+
+bool CanvasBatch::TakeSubmissions()
+{
+	std::vector<Layer> submitted;
+	std::vector<int> cleared;
+	{
+		std::lock_guard lock(mutex_);
+		submitted.swap(pending_);
+		cleared.swap(pendingClears_);
+	}
+
+	bool changed = false;
+	for (int id : cleared)
+	{
+		changed |= std::erase_if(layers_, [id](const Layer& layer) { return layer.id == id; }) > 0;
+	}
+	for (Layer& layer : submitted)
+	{
+		auto existing = std::ranges::find(layers_, layer.id, &Layer::id);
+		if (existing == layers_.end())
+		{
+			layers_.push_back(std::move(layer));
+			changed = true;
+		}
+		else if (!(existing->commands == layer.commands))
+		{
+			// Most overlays record the same frame over and over, those don't need a rebuild
+			existing->commands = std::move(layer.commands);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+void CanvasBatch::Rebuild()
+{
+	std::ranges::sort(layers_, {}, &Layer::id);
+	ops_.clear();
+	texts_.clear();
+	stats_.commands = 0;
+	stats_.unbatchedCalls = 0;
+
+	using Command = CanvasCommands::Command;
+	std::vector<const Command*> sorted;
+	for (const Layer& layer : layers_)
+	{
+		const CanvasCommands& commands = layer.commands;
+		sorted.clear();
+		for (const Command& command : commands.Commands())
+		{
+			sorted.push_back(&command);
+		}
+		stats_.commands += sorted.size();
+
+		// Group by the state the canvas needs for each command: color first, then the kind of draw
+		auto key = [&commands](const Command* c)
+		{
+			return std::tuple(c->color, c->kind, c->size, c->dropShadow, c->x, c->y, c->x2, c->y2, commands.Text(*c));
+		};
+		std::ranges::stable_sort(sorted, {}, key);
+		const auto duplicates = std::ranges::unique(sorted, {}, key);
+		sorted.erase(duplicates.begin(), duplicates.end());
+
+		for (const Command* command : sorted)
+		{
+			uint32_t text = 0;
+			if (command->kind == CanvasCommands::Kind::Text)
+			{
+				text = static_cast<uint32_t>(texts_.size());
+				texts_.emplace_back(commands.Text(*command));
+			}
+			ops_.push_back({command, text});
+		}
+
+		for (const Command& command : commands.Commands())
+		{
+			// SetColor on each command, plus SetPosition for everything but lines
+			stats_.unbatchedCalls += command.kind == CanvasCommands::Kind::Line ? 2 : 3;
+		}
+	}
+}
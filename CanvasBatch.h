@@ -0,0 +1,177 @@
+#pragma once
+#include "bakkesmod/wrappers/canvaswrapper.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Canvas draw calls recorded into a buffer instead of issued directly. Record on any thread, then Submit to a CanvasBatch.
+class CanvasCommands
+{
+public:
+	enum class Kind : uint8_t
+	{
+		Line,
+		Box,
+		FilledBox,
+		Text,
+	};
+
+	struct Command
+	{
+		uint32_t color;  // 0xRRGGBBAA
+		Kind kind;
+		bool dropShadow;
+		float x, y;      // line start, box or text position
+		float x2, y2;    // line end or box size
+		float size;      // line width or text scale
+		uint32_t textOffset;
+		uint32_t textLength;
+
+		bool operator==(const Command&) const = default;
+	};
+
+	// Applies to the commands recorded after it
+	void SetColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) { color_ = (uint32_t{r} << 24) | (uint32_t{g} << 16) | (uint32_t{b} << 8) | a; }
+
+	void DrawLine(Vector2F start, Vector2F end, float width = 1.0f) { Add({color_, Kind::Line, false, start.X, start.Y, end.X, end.Y, width, 0, 0}); }
+	void DrawBox(Vector2F position, Vector2F size) { Add({color_, Kind::Box, false, position.X, position.Y, size.X, size.Y, 0, 0, 0}); }
+	void FillBox(Vector2F position, Vector2F size) { Add({color_, Kind::FilledBox, false, position.X, position.Y, size.X, size.Y, 0, 0, 0}); }
+	void DrawString(Vector2F position, std::string_view text, float scale = 1.0f, bool dropShadow = false);
+
+	void Clear();
+	[[nodiscard]] size_t Size() const { return commands_.size(); }
+	[[nodiscard]] const std::vector<Command>& Commands() const { return commands_; }
+	[[nodiscard]] std::string_view Text(const Command& command) const { return std::string_view(text_).substr(command.textOffset, command.textLength); }
+
+	bool operator==(const CanvasCommands& other) const { return commands_ == other.commands_ && text_ == other.text_; }
+
+private:
+	void Add(const Command& command) { commands_.push_back(command); }
+
+	std::vector<Command> commands_;
+	// Every string of the frame back to back, commands point into it
+	std::string text_;
+	uint32_t color_ = 0xFFFFFFFF;
+};
+
+// Collects the command buffers of any number of layers and draws them from the RegisterDrawable callback:
+//   gameWrapper->RegisterDrawable([this](CanvasWrapper canvas) { canvasBatch.Draw(canvas); });
+//
+// Layers are drawn in ascending order. Within a layer commands are grouped by color and type, so overlapping draws of
+// different colors should go on different layers. A layer submitted with the same commands as before doesn't trigger
+// a rebuild, and identical commands in a frame are only drawn once.
+class CanvasBatch
+{
+public:
+	struct DrawStats
+	{
+		size_t commands = 0;
+		// Calls made on the canvas, and what drawing every command on its own would have taken
+		size_t canvasCalls = 0;
+		size_t unbatchedCalls = 0;
+		bool rebuilt = false;
+	};
+
+	// Replaces what the layer draws, from the next frame on. Any thread.
+	void Submit(int layer, CanvasCommands commands);
+	void ClearLayer(int layer);
+
+	// Draws every layer. Canvas is CanvasWrapper, or anything with the same drawing methods (see CountingCanvas).
+	template <typename Canvas>
+	void Draw(Canvas& canvas)
+	{
+		stats_.rebuilt = TakeSubmissions();
+		if (stats_.rebuilt)
+		{
+			Rebuild();
+		}
+
+		size_t calls = 0;
+		uint32_t color = 0;
+		bool hasColor = false;
+		for (const Op& op : ops_)
+		{
+			const CanvasCommands::Command& command = *op.command;
+			if (!hasColor || command.color != color)
+			{
+				color = command.color;
+				hasColor = true;
+				canvas.SetColor(static_cast<char>(color >> 24), static_cast<char>(color >> 16), static_cast<char>(color >> 8), static_cast<char>(color));
+				++calls;
+			}
+			switch (command.kind)
+			{
+			case CanvasCommands::Kind::Line:
+				canvas.DrawLine(Vector2F{command.x, command.y}, Vector2F{command.x2, command.y2}, command.size);
+				calls += 1;
+				break;
+			case CanvasCommands::Kind::Box:
+				canvas.SetPosition(Vector2F{command.x, command.y});
+				canvas.DrawBox(Vector2F{command.x2, command.y2});
+				calls += 2;
+				break;
+			case CanvasCommands::Kind::FilledBox:
+				canvas.SetPosition(Vector2F{command.x, command.y});
+				canvas.FillBox(Vector2F{command.x2, command.y2});
+				calls += 2;
+				break;
+			case CanvasCommands::Kind::Text:
+				canvas.SetPosition(Vector2F{command.x, command.y});
+				canvas.DrawString(texts_[op.text], command.size, command.size, command.dropShadow, false);
+				calls += 2;
+				break;
+			}
+		}
+		stats_.canvasCalls = calls;
+	}
+
+	// About the last Draw. Read on the thread that draws.
+	[[nodiscard]] const DrawStats& LastStats() const { return stats_; }
+
+private:
+	struct Layer
+	{
+		int id;
+		CanvasCommands commands;
+	};
+
+	struct Op
+	{
+		const CanvasCommands::Command* command;
+		uint32_t text;  // index into texts_
+	};
+
+	// Moves the pending submissions into the drawn layers. True if what is drawn changed.
+	bool TakeSubmissions();
+	void Rebuild();
+
+	std::mutex mutex_;
+	std::vector<Layer> pending_;
+	std::vector<int> pendingClears_;
+
+	// Only touched by the drawing thread
+	std::vector<Layer> layers_;
+	std::vector<Op> ops_;
+	std::vector<std::string> texts_;
+	DrawStats stats_;
+};
+
+// Stand-in canvas that counts calls instead of drawing, for measuring a batch without the game
+struct CountingCanvas
+{
+	size_t setColor = 0;
+	size_t setPosition = 0;
+	size_t draws = 0;
+
+	void SetColor(char, char, char, char) { ++setColor; }
+	void SetPosition(Vector2F) { ++setPosition; }
+	void DrawLine(Vector2F, Vector2F, float) { ++draws; }
+	void DrawBox(Vector2F) { ++draws; }
+	void FillBox(Vector2F) { ++draws; }
+	void DrawString(const std::string&, float, float, bool, bool) { ++draws; }
+
+	[[nodiscard]] size_t Calls() const { return setColor + setPosition + draws; }
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+// Mirrors cvars into the fields of a plain struct, so hot code reads settings.field instead of looking the
+// cvar up by name and parsing its string value every tick.
+//
+//   struct Settings { bool enabled = false; float scale = 1.0f; int mode = 0; };
+//   CvarCache<Settings> settings;
+//   settings.Bind(&Settings::scale, cvarManager->registerCvar("myplugin_scale", "1.0", "Scale"));
+//   ...
+//   if (settings.Get().enabled) ...          // game thread
+//   const Settings s = settings.Snapshot(); // any other thread
+//
+// Updates come from the cvars' addOnValueChanged callbacks (on the game thread). Each update writes the
+// inactive half of a double buffer and then publishes it, so game thread readers never see a half written struct.
+template <typename Settings>
+class CvarCache
+{
+	static_assert(std::is_trivially_copyable_v<Settings>, "CvarCache settings must be a plain struct");
+
+public:
+	explicit CvarCache(const Settings& defaults = {})
+	{
+		buffers_[0] = defaults;
+		buffers_[1] = defaults;
+	}
+
+	CvarCache(const CvarCache&) = delete;
+	CvarCache& operator=(const CvarCache&) = delete;
+
+	// Copies the cvar's value into `field` now and whenever it changes. Supports bool, integral, enum and floating point fields.
+	template <typename T>
+	CVarWrapper Bind(T Settings::* field, CVarWrapper cvar)
+	{
+		static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "CvarCache can only bind arithmetic and enum fields");
+
+		Set(field, Read<T>(cvar));
+		cvar.addOnValueChanged([this, field](std::string, CVarWrapper changed)
+		{
+			Set(field, Read<T>(changed));
+		});
+		return cvar;
+	}
+
+	// The current values. Meant for the game thread, where the updates happen too: no lookup, no lock, no copy.
+	[[nodiscard]] const Settings& Get() const
+	{
+		return buffers_[current_.load(std::memory_order_acquire)];
+	}
+
+	// A consistent copy for other threads. Retries if an update was published while copying.
+	[[nodiscard]] Settings Snapshot() const
+	{
+		Settings copy;
+		for (;;)
+		{
+			const uint32_t before = sequence_.load(std::memory_order_acquire);
+			if (before & 1)
+			{
+				continue;
+			}
+			std::memcpy(&copy, &buffers_[current_.load(std::memory_order_acquire)], sizeof(Settings));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence_.load(std::memory_order_relaxed) == before)
+			{
+				return copy;
+			}
+		}
+	}
+
+	// Bumped on every update, so callers can cheaply tell whether something changed since they last looked.
+	[[nodiscard]] uint32_t Version() const
+	{
+		return sequence_.load(std::memory_order_acquire) / 2;
+	}
+
+private:
+	template <typename T>
+	static T Read(CVarWrapper& cvar)
+	{
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			return cvar.getBoolValue();
+		}
+		else if constexpr (std::is_enum_v<T> || std::is_integral_v<T>)
+		{
+			return static_cast<T>(cvar.getIntValue());
+		}
+		else
+		{
+			return static_cast<T>(cvar.getFloatValue());
+		}
+	}
+
+	template <typename T>
+	void Set(T Settings::* field, T value)
+	{
+		const uint32_t current = current_.load(std::memory_order_relaxed);
+		const uint32_t next = current ^ 1;
+
+		// Odd while the inactive buffer is being written, so Snapshot() on another thread retries
+		sequence_.fetch_add(1, std::memory_order_acq_rel);
+		buffers_[next] = buffers_[current];
+		buffers_[next].*field = value;
+		current_.store(next, std::memory_order_release);
+		sequence_.fetch_add(1, std::memory_order_release);
+	}
+
+	Settings buffers_[2];
+	std::atomic<uint32_t> current_{0};
+	std::atomic<uint32_t> sequence_{0};
+};
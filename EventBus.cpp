@@ -0,0 +1,174 @@
+#include "pch.h"
+#include "EventBus.h"
+
+#include <algorithm>
+
+EventBus::EventBus(std::shared_ptr<GameWrapper> gameWrapper, HookProfiler* profiler)
+	: gameWrapper_(std::move(gameWrapper)), profiler_(profiler)
+{
+}
+
+EventBus::~EventBus()
+{
+	for (const auto& [key, topic] : topics_)
+	{
+		topic->post ? gameWrapper_->UnhookEventPost(topic->eventName) : gameWrapper_->UnhookEvent(topic->eventName);
+	}
+}
+
+EventBus::SubscriptionId EventBus::Subscribe(const std::string& eventName, Callback callback, void* context, EventOptions options)
+{
+	Topic& topic = GetTopic(eventName, options.post);
+	if (options.coalesce)
+	{
+		topic.coalesce = true;
+		// Bursts are detected per tick, so the tick has to be counted
+		if (!tickTopic_)
+		{
+			tickTopic_ = &GetTopic(TICK_EVENT, false);
+		}
+	}
+
+	const SubscriptionId id = nextId_++;
+	topic.subscribers.push_back({callback, context, id});
+	owners_[id] = &topic;
+	return id;
+}
+
+EventBus::SubscriptionId EventBus::Subscribe(const std::string& eventName, std::function<void(ActorWrapper, void*)> handler, EventOptions options)
+{
+	auto owned = std::make_unique<std::function<void(ActorWrapper, void*)>>(std::move(handler));
+	auto* context = owned.get();
+	const SubscriptionId id = Subscribe(eventName, [](void* ctx, ActorWrapper caller, void* params)
+	{
+		(*static_cast<std::function<void(ActorWrapper, void*)>*>(ctx))(caller, params);
+	}, context, options);
+	handlers_[id] = std::move(owned);
+	return id;
+}
+
+void EventBus::Unsubscribe(SubscriptionId id)
+{
+	const auto owner = owners_.find(id);
+	if (owner == owners_.end())
+	{
+		return;
+	}
+
+	Topic& topic = *owner->second;
+	owners_.erase(owner);
+	for (auto& subscriber : topic.subscribers)
+	{
+		if (subscriber.id == id)
+		{
+			// Removed from the array after the dispatch in progress (if any) is done with it
+			subscriber.callback = nullptr;
+			topic.hasRemoved = true;
+			break;
+		}
+	}
+	if (topic.dispatchDepth == 0)
+	{
+		Compact(topic);
+		handlers_.erase(id);
+	}
+}
+
+std::vector<EventBus::TopicStats> EventBus::GetStats() const
+{
+	std::vector<TopicStats> stats;
+	stats.reserve(topics_.size());
+	for (const auto& [key, topic] : topics_)
+	{
+		stats.push_back({key, topic->dispatched, topic->coalesced, topic->subscribers.size()});
+	}
+	return stats;
+}
+
+EventBus::Topic& EventBus::GetTopic(const std::string& eventName, bool post)
+{
+	const std::string key = post ? eventName + " (post)" : eventName;
+	auto& topic = topics_[key];
+	if (topic)
+	{
+		return *topic;
+	}
+
+	topic = std::make_unique<Topic>();
+	topic->eventName = eventName;
+	topic->post = post;
+	Topic* raw = topic.get();
+	std::function<void(ActorWrapper, void*, std::string)> hook = [this, raw](ActorWrapper caller, void* params, std::string)
+	{
+		Dispatch(*raw, caller, params);
+	};
+
+	if (profiler_)
+	{
+		post ? profiler_->HookEventWithCallerPost<ActorWrapper>(eventName, std::move(hook))
+		     : profiler_->HookEventWithCaller<ActorWrapper>(eventName, std::move(hook));
+	}
+	else
+	{
+		post ? gameWrapper_->HookEventWithCallerPost<ActorWrapper>(eventName, std::move(hook))
+		     : gameWrapper_->HookEventWithCaller<ActorWrapper>(eventName, std::move(hook));
+	}
+	return *topic;
+}
+
+void EventBus::Dispatch(Topic& topic, ActorWrapper caller, void* params)
+{
+	if (&topic == tickTopic_)
+	{
+		++tick_;
+	}
+
+	if (topic.coalesce)
+	{
+		if (topic.lastTick == tick_)
+		{
+			++topic.coalesced;
+			return;
+		}
+		topic.lastTick = tick_;
+	}
+	++topic.dispatched;
+
+	{
+		// Restored even if a handler throws, otherwise every later Unsubscribe on the topic would be deferred for good
+		struct DepthGuard
+		{
+			int& depth;
+			explicit DepthGuard(int& d) : depth(d) { ++depth; }
+			~DepthGuard() { --depth; }
+		} guard(topic.dispatchDepth);
+
+		// Indexing instead of iterators: a subscriber may subscribe more handlers while we walk the array
+		for (size_t i = 0; i < topic.subscribers.size(); ++i)
+		{
+			const Subscriber subscriber = topic.subscribers[i];
+			if (subscriber.callback)
+			{
+				subscriber.callback(subscriber.context, caller, params);
+			}
+		}
+	}
+
+	if (topic.hasRemoved && topic.dispatchDepth == 0)
+	{
+		for (const auto& subscriber : topic.subscribers)
+		{
+			if (!subscriber.callback)
+			{
+				handlers_.erase(subscriber.id);
+			}
+		}
+		Compact(topic);
+	}
+}
+
+void EventBus::Compact(Topic& topic)
+{
+	std::erase_if(topic.subscribers, [](const Subscriber& subscriber) { return subscriber.callback == nullptr; });
+	topic.hasRemoved = false;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "bakkesmod/wrappers/GameWrapper.h"
+#include "HookProfiler.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct EventOptions
+{
+	// Subscribe to the post hook instead of the pre hook
+	bool post = false;
+	// Only the first call of the event in a tick is dispatched, the rest of the burst is dropped.
+	// This is a property of the event: once a subscriber asks for it, every subscriber gets it.
+	bool coalesce = false;
+};
+
+// Hooks each UE function once and fans the call out to any number of subscribers.
+// Subscribers of one event sit in a flat array of {function pointer, context}, so a dispatch is a
+// linear walk with no hashing and no std::function unless the subscriber is a lambda.
+// Everything here runs on the game thread.
+class EventBus
+{
+public:
+	using Callback = void (*)(void* context, ActorWrapper caller, void* params);
+	using SubscriptionId = uint32_t;
+
+	// Fires once per rendered frame, also in menus. Used to detect bursts when coalescing.
+	static constexpr const char* TICK_EVENT = "Function Engine.GameViewportClient.Tick";
+
+	struct TopicStats
+	{
+		std::string eventName;
+		uint64_t dispatched = 0;
+		uint64_t coalesced = 0;
+		size_t subscribers = 0;
+	};
+
+	// Pass a profiler to time each event's whole dispatch in its table.
+	explicit EventBus(std::shared_ptr<GameWrapper> gameWrapper, HookProfiler* profiler = nullptr);
+	// Unhooks every event the bus hooked. The SDK unhooks by event name, so any other hook the plugin
+	// has on one of those events goes with it.
+	~EventBus();
+
+	// The hooks point at this instance
+	EventBus(const EventBus&) = delete;
+	EventBus& operator=(const EventBus&) = delete;
+
+	SubscriptionId Subscribe(const std::string& eventName, Callback callback, void* context, EventOptions options = {});
+	// One extra indirection per call compared to the other overloads.
+	SubscriptionId Subscribe(const std::string& eventName, std::function<void(ActorWrapper, void*)> handler, EventOptions options = {});
+
+	// Calls object->Method(caller, params), or object->Method() if it takes no arguments.
+	template <auto Method, typename T>
+	SubscriptionId Subscribe(const std::string& eventName, T* object, EventOptions options = {})
+	{
+		return Subscribe(eventName, [](void* context, ActorWrapper caller, void* params)
+		{
+			if constexpr (std::is_invocable_v<decltype(Method), T*, ActorWrapper, void*>)
+			{
+				(static_cast<T*>(context)->*Method)(caller, params);
+			}
+			else
+			{
+				(static_cast<T*>(context)->*Method)();
+			}
+		}, object, options);
+	}
+
+	// Safe to call from inside a dispatch.
+	void Unsubscribe(SubscriptionId id);
+
+	[[nodiscard]] uint64_t CurrentTick() const { return tick_; }
+	[[nodiscard]] std::vector<TopicStats> GetStats() const;
+
+private:
+	struct Subscriber
+	{
+		Callback callback;
+		void* context;
+		SubscriptionId id;
+	};
+
+	struct Topic
+	{
+		std::string eventName;
+		std::vector<Subscriber> subscribers;
+		bool post = false;
+		bool coalesce = false;
+		int dispatchDepth = 0;  // events can fire from inside their own handlers
+		bool hasRemoved = false;
+		uint64_t lastTick = ~0ull;
+		uint64_t dispatched = 0;
+		uint64_t coalesced = 0;
+	};
+
+	Topic& GetTopic(const std::string& eventName, bool post);
+	void Dispatch(Topic& topic, ActorWrapper caller, void* params);
+	static void Compact(Topic& topic);
+
+	std::shared_ptr<GameWrapper> gameWrapper_;
+	HookProfiler* profiler_;
+	std::unordered_map<std::string, std::unique_ptr<Topic>> topics_;
+	std::unordered_map<SubscriptionId, Topic*> owners_;
+	std::unordered_map<SubscriptionId, std::unique_ptr<std::function<void(ActorWrapper, void*)>>> handlers_;
+	SubscriptionId nextId_ = 1;
+	Topic* tickTopic_ = nullptr;
+	uint64_t tick_ = 0;
+};
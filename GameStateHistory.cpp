@@ -0,0 +1,201 @@
+#include "pch.h"
+#include "GameStateHistory.h"
+
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+
+GameStateHistory::GameStateHistory(size_t capacity)
+	: capacity_((std::max)(capacity, size_t{1})),
+	data_(static_cast<size_t>(OBJECTS) * CHANNELS * capacity_),
+	times_(capacity_),
+	carCounts_(capacity_),
+	pads_(capacity_)
+{
+}
+
+void GameStateHistory::Store(int object, size_t slot, ActorWrapper actor)
+{
+	Vector location{}, velocity{}, angularVelocity{};
+	if (actor)
+	{
+		location = actor.GetLocation();
+		velocity = actor.GetVelocity();
+		angularVelocity = actor.GetAngularVelocity();
+	}
+	const float values[] = {location.X, location.Y, location.Z, velocity.X, velocity.Y, velocity.Z, angularVelocity.X, angularVelocity.Y, angularVelocity.Z};
+	for (int channel = X; channel <= WZ; ++channel)
+	{
+		ChannelData(object, static_cast<Channel>(channel))[slot] = values[channel];
+	}
+}
+
+void GameStateHistory::Capture(ServerWrapper server)
+{
+	if (!server)
+	{
+		return;
+	}
+
+	const uint64_t tick = written_.load(std::memory_order_relaxed);
+	const size_t slot = static_cast<size_t>(tick % capacity_);
+
+	Store(BALL, slot, server.GetBall());
+	ChannelData(BALL, BOOST)[slot] = 0.0f;
+
+	auto cars = server.GetCars();
+	const int carCount = (std::min)(cars.Count(), MAX_CARS);
+	for (int i = 0; i < MAX_CARS; ++i)
+	{
+		const int object = 1 + i;
+		CarWrapper car = i < carCount ? cars.Get(i) : CarWrapper(0);
+		Store(object, slot, car);
+		float boost = 0.0f;
+		if (car)
+		{
+			BoostWrapper boostComponent = car.GetBoostComponent();
+			if (!boostComponent.IsNull())
+			{
+				boost = boostComponent.GetCurrentBoostAmount();
+			}
+		}
+		ChannelData(object, BOOST)[slot] = boost;
+	}
+
+	times_[slot] = std::chrono::duration<float>(Clock::now() - start_).count();
+	carCounts_[slot] = static_cast<uint8_t>(carCount);
+	pads_[slot] = padMask_;
+	// Publishes the slot. Readers check this again after reading to notice when the writer lapped them.
+	written_.store(tick + 1, std::memory_order_release);
+}
+
+void GameStateHistory::SetPadActive(int pad, bool active)
+{
+	if (pad < 0 || pad >= MAX_PADS)
+	{
+		return;
+	}
+	const uint64_t bit = uint64_t{1} << pad;
+	padMask_ = active ? padMask_ | bit : padMask_ & ~bit;
+}
+
+void GameStateHistory::Clear()
+{
+	cleared_.store(written_.load(std::memory_order_relaxed), std::memory_order_release);
+	padMask_ = 0;
+	start_ = Clock::now();
+}
+
+uint64_t GameStateHistory::Begin() const
+{
+	const uint64_t end = End();
+	// The oldest slot is the one the next Capture overwrites, so it doesn't count as stored
+	const uint64_t oldest = end >= capacity_ ? end - capacity_ + 1 : 0;
+	return (std::max)(oldest, cleared_.load(std::memory_order_acquire));
+}
+
+bool GameStateHistory::Available(uint64_t first, size_t count) const
+{
+	const uint64_t end = End();
+	const uint64_t begin = end >= capacity_ ? end - capacity_ + 1 : 0;
+	return count < capacity_ && first >= begin && first >= cleared_.load(std::memory_order_acquire) && first + count <= end;
+}
+
+bool GameStateHistory::StillValid(uint64_t first, size_t count) const
+{
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const uint64_t end = written_.load(std::memory_order_relaxed);
+	// The writer may be filling the slot of tick `end` right now, which held tick end - capacity.
+	// Ticks from before a Clear() that happened while reading don't count either.
+	return first + count <= end && first + capacity_ > end && first >= cleared_.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+bool GameStateHistory::CopyRing(const std::vector<T>& ring, uint64_t first, std::span<T> out) const
+{
+	if (!Available(first, out.size()))
+	{
+		return false;
+	}
+	ForEachSegment(first, out.size(), [&](size_t slot, size_t count, size_t offset)
+	{
+		std::memcpy(out.data() + offset, ring.data() + slot, count * sizeof(T));
+	});
+	return StillValid(first, out.size());
+}
+
+bool GameStateHistory::Copy(int object, Channel channel, uint64_t first, std::span<float> out) const
+{
+	if (object < 0 || object >= OBJECTS || channel < 0 || channel >= CHANNELS || !Available(first, out.size()))
+	{
+		return false;
+	}
+	const float* data = ChannelData(object, channel);
+	ForEachSegment(first, out.size(), [&](size_t slot, size_t count, size_t offset)
+	{
+		std::memcpy(out.data() + offset, data + slot, count * sizeof(float));
+	});
+	return StillValid(first, out.size());
+}
+
+bool GameStateHistory::CopyTimes(uint64_t first, std::span<float> out) const
+{
+	return CopyRing(times_, first, out);
+}
+
+bool GameStateHistory::CopyCarCounts(uint64_t first, std::span<uint8_t> out) const
+{
+	return CopyRing(carCounts_, first, out);
+}
+
+bool GameStateHistory::CopyPads(uint64_t first, std::span<uint64_t> out) const
+{
+	return CopyRing(pads_, first, out);
+}
+
+std::optional<float> GameStateHistory::MaxSpeed(int object, size_t ticks) const
+{
+	const uint64_t end = End();
+	if (object < 0 || object >= OBJECTS || ticks == 0 || ticks > end)
+	{
+		return std::nullopt;
+	}
+	const uint64_t first = end - ticks;
+	if (!Available(first, ticks))
+	{
+		return std::nullopt;
+	}
+
+	const float* vx = ChannelData(object, VX);
+	const float* vy = ChannelData(object, VY);
+	const float* vz = ChannelData(object, VZ);
+	__m128 best = _mm_setzero_ps();
+	float bestTail = 0.0f;
+	ForEachSegment(first, ticks, [&](size_t slot, size_t count, size_t)
+	{
+		// Squared speeds four ticks at a time, one square root at the end
+		size_t i = slot;
+		const size_t end4 = slot + count / 4 * 4;
+		for (; i < end4; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(vx + i);
+			const __m128 y = _mm_loadu_ps(vy + i);
+			const __m128 z = _mm_loadu_ps(vz + i);
+			const __m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			best = _mm_max_ps(best, squared);
+		}
+		for (; i < slot + count; ++i)
+		{
+			bestTail = (std::max)(bestTail, vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+		}
+	});
+
+	best = _mm_max_ps(best, _mm_movehl_ps(best, best));
+	best = _mm_max_ss(best, _mm_shuffle_ps(best, best, 1));
+	const float squared = (std::max)(_mm_cvtss_f32(best), bestTail);
+	if (!StillValid(first, ticks))
+	{
+		return std::nullopt;
+	}
+	return std::sqrt(squared);
+}
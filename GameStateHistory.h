@@ -0,0 +1,108 @@
+#pragma once
+#include "bakkesmod/wrappers/GameWrapper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// The last N ticks of ball and car state, captured once per tick and stored as one float array per value
+// (structure of arrays), so readers walk contiguous memory instead of going through the wrappers again.
+//
+// Capture runs on the game thread. Readers on any thread use Copy/MaxSpeed: they never block the writer and
+// report failure when the ticks they asked for were overwritten while they read them.
+class GameStateHistory
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Object 0 is the ball, 1..MAX_CARS are the cars in ServerWrapper::GetCars() order
+	static constexpr int BALL = 0;
+	static constexpr int MAX_CARS = 8;
+	static constexpr int OBJECTS = 1 + MAX_CARS;
+	// One bit per pad, soccar has 34
+	static constexpr int MAX_PADS = 64;
+
+	enum Channel
+	{
+		X, Y, Z,
+		VX, VY, VZ,
+		WX, WY, WZ,
+		BOOST,  // 0-1, always 0 for the ball
+		CHANNELS
+	};
+
+	// 30 seconds at 120 Hz
+	explicit GameStateHistory(size_t capacity = 30 * 120);
+
+	GameStateHistory(const GameStateHistory&) = delete;
+	GameStateHistory& operator=(const GameStateHistory&) = delete;
+
+	// Records one tick. Game thread only.
+	void Capture(ServerWrapper server);
+	// The SDK has no boost pad state on ServerWrapper, so pickups are reported by the caller (for example from the
+	// pad pickup hooks) and saved with each following Capture.
+	void SetPadActive(int pad, bool active);
+	// Forgets everything captured so far, for example when a match ends. Game thread only.
+	void Clear();
+
+	// Ticks are numbered from 0 when the history is created and keep counting across Clear(), so a tick number
+	// a reader kept from before a Clear() never refers to a newer tick. End() is one past the newest captured tick.
+	[[nodiscard]] uint64_t End() const { return written_.load(std::memory_order_acquire); }
+	// The oldest tick still stored, End() if nothing was captured since the last Clear()
+	[[nodiscard]] uint64_t Begin() const;
+	[[nodiscard]] size_t Capacity() const { return capacity_; }
+
+	// Copies one value of one object for ticks [first, first + out.size()). Returns false if part of that range
+	// isn't stored (not captured yet, or already overwritten), in which case out has to be discarded.
+	bool Copy(int object, Channel channel, uint64_t first, std::span<float> out) const;
+	// Same for the per tick data: capture time in seconds since the last Clear(), number of cars, pad bitmask.
+	bool CopyTimes(uint64_t first, std::span<float> out) const;
+	bool CopyCarCounts(uint64_t first, std::span<uint8_t> out) const;
+	bool CopyPads(uint64_t first, std::span<uint64_t> out) const;
+
+	// The highest speed of an object over the newest `ticks` ticks, nullopt if there isn't that much history
+	// or it was overwritten while reading.
+	[[nodiscard]] std::optional<float> MaxSpeed(int object, size_t ticks) const;
+
+private:
+	[[nodiscard]] float* ChannelData(int object, Channel channel) { return data_.data() + (static_cast<size_t>(object) * CHANNELS + channel) * capacity_; }
+	[[nodiscard]] const float* ChannelData(int object, Channel channel) const { return data_.data() + (static_cast<size_t>(object) * CHANNELS + channel) * capacity_; }
+	void Store(int object, size_t slot, ActorWrapper actor);
+
+	// Whether ticks [first, first + count) are stored, before reading them
+	[[nodiscard]] bool Available(uint64_t first, size_t count) const;
+	// Whether they are still stored after reading them
+	[[nodiscard]] bool StillValid(uint64_t first, size_t count) const;
+
+	// Calls fn(slot, count, outOffset) for the one or two contiguous parts of the ring covering the ticks
+	template <typename Fn>
+	void ForEachSegment(uint64_t first, size_t count, Fn&& fn) const
+	{
+		size_t done = 0;
+		while (done < count)
+		{
+			const size_t slot = static_cast<size_t>((first + done) % capacity_);
+			const size_t length = (std::min)(count - done, capacity_ - slot);
+			fn(slot, length, done);
+			done += length;
+		}
+	}
+
+	template <typename T>
+	bool CopyRing(const std::vector<T>& ring, uint64_t first, std::span<T> out) const;
+
+	size_t capacity_;
+	std::vector<float> data_;
+	std::vector<float> times_;
+	std::vector<uint8_t> carCounts_;
+	std::vector<uint64_t> pads_;
+	uint64_t padMask_ = 0;
+	Clock::time_point start_ = Clock::now();
+	std::atomic<uint64_t> written_{0};
+	// The first tick captured after the last Clear()
+	std::atomic<uint64_t> cleared_{0};
+};
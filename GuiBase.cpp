@@ -1,5 +1,9 @@
 ﻿#include "pch.h"
 #include "GuiBase.h"
+#include "GuiProfiler.h"
+#include "IMGUI/imgui_internal.h"
+
+#include <algorithm>
 
 std::string SettingsWindowBase::GetPluginName()
 {
@@ -11,6 +15,41 @@ void SettingsWindowBase::SetImGuiContext(uintptr_t ctx)
 	ImGui::SetCurrentContext(reinterpret_cast<ImGuiContext*>(ctx));
 }
 
+struct PluginWindowBase::RetainedContent
+{
+	struct Command
+	{
+		ImVec4 clipRect;
+		ImTextureID texture;
+		unsigned int elemCount;
+	};
+
+	ImVector<Command> commands;
+	ImVector<ImDrawVert> vertices;
+	ImVector<ImDrawIdx> indices;  // relative to the first vertex
+	ImVec2 cursorMaxPos;  // relative to the window position
+	bool valid = false;
+
+	// What the content was built for
+	ImVec2 position;
+	ImVec2 size;
+	ImVec2 scroll;
+	float fontSize = 0.0f;
+	uint64_t version = 0;
+};
+
+namespace
+{
+	bool Same(const ImVec2& a, const ImVec2& b)
+	{
+		return a.x == b.x && a.y == b.y;
+	}
+}
+
+PluginWindowBase::PluginWindowBase() = default;
+
+PluginWindowBase::~PluginWindowBase() = default;
+
 std::string PluginWindowBase::GetMenuName()
 {
 	return "$projectname$";
@@ -24,6 +63,7 @@ std::string PluginWindowBase::GetMenuTitle()
 void PluginWindowBase::SetImGuiContext(uintptr_t ctx)
 {
 	ImGui::SetCurrentContext(reinterpret_cast<ImGuiContext*>(ctx));
+	MarkDirty();
 }
 
 bool PluginWindowBase::ShouldBlockInput()
@@ -39,6 +79,7 @@ bool PluginWindowBase::IsActiveOverlay()
 void PluginWindowBase::OnOpen()
 {
 	isWindowOpen_ = true;
+	MarkDirty();
 }
 
 void PluginWindowBase::OnClose()
@@ -48,6 +89,7 @@ void PluginWindowBase::OnClose()
 
 void PluginWindowBase::Render()
 {
+	GuiZone zone("PluginWindowBase::Render");
 	if (!ImGui::Begin(menuTitle_.c_str(), &isWindowOpen_, ImGuiWindowFlags_None))
 	{
 		// Early out if the window is collapsed, as an optimization.
@@ -55,7 +97,15 @@ void PluginWindowBase::Render()
 		return;
 	}
 
-	RenderWindow();
+	if (retainContent_)
+	{
+		RenderRetained();
+	}
+	else
+	{
+		GuiZone windowZone("RenderWindow");
+		RenderWindow();
+	}
 
 	ImGui::End();
 
@@ -64,3 +114,104 @@ void PluginWindowBase::Render()
 		_globalCvarManager->executeCommand("togglemenu " + GetMenuName());
 	}
 }
+
+void PluginWindowBase::MarkDirty()
+{
+	dirty_ = true;
+}
+
+void PluginWindowBase::RenderRetained()
+{
+	ImGuiContext& g = *ImGui::GetCurrentContext();
+	ImGuiWindow* window = g.CurrentWindow;
+	ImDrawList* drawList = window->DrawList;
+	if (!retained_)
+	{
+		retained_ = std::make_unique<RetainedContent>();
+	}
+	RetainedContent& cache = *retained_;
+
+	// Hover effects, keyboard navigation and active widgets (drags, text input) all need the widgets submitted
+	const bool navigating = g.NavWindow && g.NavWindow->RootWindow == window && !g.NavDisableHighlight;
+	const bool idle = !window->Rect().Contains(g.IO.MousePos) && !navigating && g.ActiveId == 0;
+	const uint64_t version = ContentVersion();
+	const bool unchanged = cache.valid && !dirty_ && cache.version == version && cache.fontSize == g.FontSize
+		&& Same(cache.position, window->Pos) && Same(cache.size, window->Size) && Same(cache.scroll, window->Scroll);
+	const bool fits = sizeof(ImDrawIdx) > 2 || drawList->_VtxCurrentIdx + cache.vertices.Size < (1u << 16);
+
+	if (idle && unchanged && fits)
+	{
+		const unsigned int base = drawList->_VtxCurrentIdx;
+		const ImDrawIdx* index = cache.indices.Data;
+		for (const RetainedContent::Command& command : cache.commands)
+		{
+			drawList->PushClipRect(ImVec2(command.clipRect.x, command.clipRect.y), ImVec2(command.clipRect.z, command.clipRect.w));
+			drawList->PushTextureID(command.texture);
+			drawList->PrimReserve(static_cast<int>(command.elemCount), 0);
+			for (unsigned int i = 0; i < command.elemCount; ++i)
+			{
+				*drawList->_IdxWritePtr++ = static_cast<ImDrawIdx>(base + *index++);
+			}
+			drawList->PopTextureID();
+			drawList->PopClipRect();
+		}
+		drawList->PrimReserve(0, cache.vertices.Size);
+		std::copy_n(cache.vertices.Data, cache.vertices.Size, drawList->_VtxWritePtr);
+		drawList->_VtxWritePtr += cache.vertices.Size;
+		drawList->_VtxCurrentIdx += cache.vertices.Size;
+
+		// Keeps the content size, and with it the scrollbars, of the frame that was recorded
+		window->DC.CursorMaxPos = ImVec2(window->Pos.x + cache.cursorMaxPos.x, window->Pos.y + cache.cursorMaxPos.y);
+		return;
+	}
+
+	const int firstCommand = drawList->CmdBuffer.Size - 1;
+	const unsigned int firstIndex = drawList->IdxBuffer.Size;
+	const int firstVertex = drawList->VtxBuffer.Size;
+	const unsigned int vertexBase = drawList->_VtxCurrentIdx;
+	const unsigned int vertexOffset = drawList->_VtxCurrentOffset;
+	const int activeWindows = g.WindowsActiveCount;
+	dirty_ = false;
+
+	{
+		GuiZone windowZone("RenderWindow");
+		RenderWindow();
+	}
+
+	cache.valid = false;
+	cache.commands.resize(0);
+	// Child windows and popups are drawn from their own draw lists, which this doesn't record
+	if (g.WindowsActiveCount != activeWindows || drawList->_VtxCurrentOffset != vertexOffset)
+	{
+		return;
+	}
+	for (int i = firstCommand; i < drawList->CmdBuffer.Size; ++i)
+	{
+		const ImDrawCmd& command = drawList->CmdBuffer[i];
+		if (command.UserCallback)
+		{
+			return;
+		}
+		const unsigned int begin = (std::max)(command.IdxOffset, firstIndex);
+		const unsigned int end = command.IdxOffset + command.ElemCount;
+		if (end > begin)
+		{
+			cache.commands.push_back({command.ClipRect, command.TextureId, end - begin});
+		}
+	}
+	cache.vertices.resize(drawList->VtxBuffer.Size - firstVertex);
+	std::copy_n(drawList->VtxBuffer.Data + firstVertex, cache.vertices.Size, cache.vertices.Data);
+	cache.indices.resize(drawList->IdxBuffer.Size - static_cast<int>(firstIndex));
+	for (int i = 0; i < cache.indices.Size; ++i)
+	{
+		cache.indices[i] = static_cast<ImDrawIdx>(drawList->IdxBuffer[static_cast<int>(firstIndex) + i] - vertexBase);
+	}
+	cache.cursorMaxPos = ImVec2(window->DC.CursorMaxPos.x - window->Pos.x, window->DC.CursorMaxPos.y - window->Pos.y);
+	cache.position = window->Pos;
+	cache.size = window->Size;
+	cache.scroll = window->Scroll;
+	cache.fontSize = g.FontSize;
+	cache.version = version;
+	// Drawn while hovered or focused, it would replay the highlights
+	cache.valid = idle;
+}
\ No newline at end of file
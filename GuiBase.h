@@ -2,6 +2,10 @@
 #include "bakkesmod/plugin/PluginSettingsWindow.h"
 #include "bakkesmod/plugin/pluginwindow.h"
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
 class SettingsWindowBase : public BakkesMod::Plugin::PluginSettingsWindow
 {
 public:
@@ -12,10 +16,15 @@ public:
 class PluginWindowBase : public BakkesMod::Plugin::PluginWindow
 {
 public:
-	virtual ~PluginWindowBase() = default;
+	PluginWindowBase();
+	virtual ~PluginWindowBase();
 
 	bool isWindowOpen_ = false;
 	std::string menuTitle_ = "$projectname$";
+	// Retained mode: while the mouse is outside the window, it doesn't have keyboard focus and neither ContentVersion()
+	// nor MarkDirty() says the data changed, the draw commands RenderWindow() made last time are drawn again instead
+	// of calling it. For windows that show a lot and change rarely. Content with child windows or popups is not retained.
+	bool retainContent_ = false;
 
 	std::string GetMenuName() override;
 	std::string GetMenuTitle() override;
@@ -27,4 +36,16 @@ public:
 	void Render() override;
 
 	virtual void RenderWindow() = 0;
+	// The version of the data the window shows, RenderWindow() runs again when it changes
+	virtual uint64_t ContentVersion() { return 0; }
+	// RenderWindow() runs again on the next frame. Any thread.
+	void MarkDirty();
+
+private:
+	struct RetainedContent;
+
+	void RenderRetained();
+
+	std::unique_ptr<RetainedContent> retained_;
+	std::atomic<bool> dirty_ = true;
 };
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "pch.h"
+#include "GuiProfiler.h"
+#include "tracing.h"
+#include "IMGUI/imgui_internal.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace
+{
+	int64_t Nanoseconds(GuiProfiler::Clock::duration duration)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	}
+
+	const ImDrawList* CurrentDrawList()
+	{
+		const ImGuiContext* context = ImGui::GetCurrentContext();
+		return context && context->CurrentWindow ? context->CurrentWindow->DrawList : nullptr;
+	}
+
+	// Same name, same color in every frame
+	ImU32 ZoneColor(const char* name)
+	{
+		uint32_t hash = 2166136261u;
+		for (const char* c = name; *c; ++c)
+		{
+			hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+		}
+		return ImColor::HSV(static_cast<float>(hash % 360) / 360.0f, 0.45f, 0.9f);
+	}
+}
+
+GuiProfiler& GuiProfiler::Get()
+{
+	static GuiProfiler profiler;
+	return profiler;
+}
+
+GuiProfiler::GuiProfiler() : frames_(FRAMES)
+{
+}
+
+GuiProfiler::Frame& GuiProfiler::StartFrame(int imguiFrame)
+{
+	current_ = (current_ + 1) % FRAMES;
+	Frame& frame = frames_[current_];
+	frame.imguiFrame = imguiFrame;
+	frame.zoneCount = 0;
+	frame.duration = 0;
+	if (tracing::IsEnabled())
+	{
+		tracing::SetThreadName("render");
+	}
+	// Zones left open by the previous frame are dropped
+	depth_ = 0;
+	return frame;
+}
+
+int GuiProfiler::BeginZone(const char* name)
+{
+	const auto now = Clock::now();
+	const int imguiFrame = ImGui::GetFrameCount();
+	Frame* frame = &frames_[current_];
+	if (frame->imguiFrame != imguiFrame)
+	{
+		frame = &StartFrame(imguiFrame);
+		frameStart_ = now;
+	}
+	if (frame->zoneCount == MAX_ZONES || depth_ == MAX_DEPTH)
+	{
+		return -1;
+	}
+
+	const int zone = frame->zoneCount++;
+	frame->zones[zone] = {name, depth_, Nanoseconds(now - frameStart_), 0, 0, 0, 0};
+	const ImDrawList* drawList = CurrentDrawList();
+	open_[depth_++] = {
+		zone, now, drawList, drawList ? drawList->VtxBuffer.Size : 0, drawList ? drawList->IdxBuffer.Size : 0,
+		ImGui::GetIO().MetricsActiveAllocations, 0, 0};
+	return zone;
+}
+
+void GuiProfiler::EndZone(int zone)
+{
+	if (depth_ == 0 || open_[depth_ - 1].zone != zone)
+	{
+		return;
+	}
+	const OpenZone& open = open_[--depth_];
+	Frame& frame = frames_[current_];
+	Zone& record = frame.zones[zone];
+	const auto end = Clock::now();
+	record.duration = Nanoseconds(end - open.start);
+
+	// A zone around a Begin/End pair starts and ends in the window outside it, only the zones inside know what was drawn
+	record.vertices = open.childVertices;
+	record.indices = open.childIndices;
+	const ImDrawList* drawList = CurrentDrawList();
+	if (drawList && drawList == open.drawList)
+	{
+		record.vertices = (std::max)(record.vertices, drawList->VtxBuffer.Size - open.vertices);
+		record.indices = (std::max)(record.indices, drawList->IdxBuffer.Size - open.indices);
+	}
+	record.allocations = ImGui::GetIO().MetricsActiveAllocations - open.allocations;
+	tracing::Complete(record.name, "gui", open.start, end, "vertices", record.vertices, "allocations", record.allocations);
+
+	if (depth_ > 0)
+	{
+		open_[depth_ - 1].childVertices += record.vertices;
+		open_[depth_ - 1].childIndices += record.indices;
+	}
+	else
+	{
+		frame.duration += record.duration;
+	}
+}
+
+const GuiProfiler::Frame* GuiProfiler::LastFrame() const
+{
+	const Frame& current = frames_[current_];
+	if (current.imguiFrame >= 0 && current.imguiFrame != ImGui::GetFrameCount())
+	{
+		return &current;
+	}
+	const Frame& previous = frames_[(current_ + FRAMES - 1) % FRAMES];
+	return previous.imguiFrame >= 0 ? &previous : nullptr;
+}
+
+void GuiProfiler::Render()
+{
+	GuiZone zone("GuiProfiler::Render");
+
+	ImGui::Checkbox("Record", &enabled);
+	const Frame* last = LastFrame();
+	if (!last)
+	{
+		ImGui::TextUnformatted("No zones recorded yet");
+		return;
+	}
+	const int newest = static_cast<int>(last - frames_.data());
+
+	// Oldest on the left, click a bar to look at that frame
+	std::array<float, FRAMES> times{};
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		const Frame& frame = frames_[(newest - (FRAMES - 1 - i) + FRAMES) % FRAMES];
+		times[i] = frame.imguiFrame >= 0 ? static_cast<float>(frame.duration) / 1e3f : 0.0f;
+	}
+	ImGui::PlotHistogram("##frames", times.data(), FRAMES, 0, "GUI us per frame", 0.0f, FLT_MAX, ImVec2(-1, 60));
+	if (ImGui::IsItemClicked())
+	{
+		const float x = (ImGui::GetIO().MousePos.x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+		selected_ = FRAMES - 1 - std::clamp(static_cast<int>(x * FRAMES), 0, FRAMES - 1);
+	}
+	ImGui::SliderInt("Frames back", &selected_, 0, FRAMES - 1);
+
+	const Frame& frame = frames_[(newest - selected_ + FRAMES) % FRAMES];
+	ImGui::Text("Frame %d: %.1f us in %d zones", frame.imguiFrame, static_cast<double>(frame.duration) / 1e3, frame.zoneCount);
+	if (frame.zoneCount == 0)
+	{
+		return;
+	}
+
+	int64_t span = 1;
+	int depth = 0;
+	for (int i = 0; i < frame.zoneCount; ++i)
+	{
+		span = (std::max)(span, frame.zones[i].start + frame.zones[i].duration);
+		depth = (std::max)(depth, frame.zones[i].depth + 1);
+	}
+
+	const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	const ImVec2 origin = ImGui::GetCursorScreenPos();
+	const float width = (std::max)(ImGui::GetContentRegionAvail().x, 1.0f);
+	ImGui::InvisibleButton("##flamegraph", ImVec2(width, rowHeight * static_cast<float>(depth)));
+	const bool graphHovered = ImGui::IsItemHovered();
+	const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	const Zone* hovered = nullptr;
+	for (int i = 0; i < frame.zoneCount; ++i)
+	{
+		const Zone& z = frame.zones[i];
+		const float x0 = origin.x + width * static_cast<float>(z.start) / static_cast<float>(span);
+		const float x1 = (std::max)(origin.x + width * static_cast<float>(z.start + z.duration) / static_cast<float>(span), x0 + 1.0f);
+		const float y0 = origin.y + rowHeight * static_cast<float>(z.depth);
+		const float y1 = y0 + rowHeight - 1.0f;
+		drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), ZoneColor(z.name));
+		if (x1 - x0 > 20.0f)
+		{
+			drawList->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y1), true);
+			drawList->AddText(ImVec2(x0 + 2.0f, y0), IM_COL32_BLACK, z.name);
+			drawList->PopClipRect();
+		}
+		if (graphHovered && mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1)
+		{
+			hovered = &z;
+		}
+	}
+	if (hovered)
+	{
+		ImGui::SetTooltip("%s\n%.2f us\n%d vertices, %d indices\n%+d allocations", hovered->name,
+			static_cast<double>(hovered->duration) / 1e3, hovered->vertices, hovered->indices, hovered->allocations);
+	}
+}
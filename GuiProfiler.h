@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+struct ImDrawList;
+
+// Timing zones for the plugin's own ImGui code. A zone records its CPU time, the vertices and indices it added to the
+// draw list and the net change in ImGui allocations (ImGuiIO::MetricsActiveAllocations). Zones nest, and Render()
+// draws the last frames as a flame graph.
+//
+//   void MyPlugin::RenderWindow()
+//   {
+//   	GuiZone zone("stats table");
+//   	...
+//   }
+//
+// PluginWindowBase::Render and RenderWindow() get zones on their own. Recording is a few clock reads and counter
+// copies per zone into preallocated frames, cheap enough to leave on. Render thread only.
+class GuiProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr int MAX_ZONES = 256;
+	static constexpr int MAX_DEPTH = 32;
+	static constexpr int FRAMES = 120;
+
+	struct Zone
+	{
+		const char* name;  // not copied, use string literals
+		int depth;
+		int64_t start;     // nanoseconds after the first zone of the frame
+		int64_t duration;  // nanoseconds
+		int vertices;
+		int indices;
+		int allocations;
+	};
+
+	struct Frame
+	{
+		int imguiFrame = -1;
+		int zoneCount = 0;
+		int64_t duration = 0;  // sum of the top level zones
+		std::array<Zone, MAX_ZONES> zones{};
+	};
+
+	static GuiProfiler& Get();
+
+	bool enabled = true;
+
+	// Use GuiZone
+	int BeginZone(const char* name);
+	void EndZone(int zone);
+
+	// The newest frame whose zones are all closed
+	[[nodiscard]] const Frame* LastFrame() const;
+
+	// Draws the frame time history and a flame graph of the selected frame. Call from RenderWindow/RenderSettings.
+	void Render();
+
+private:
+	GuiProfiler();
+
+	struct OpenZone
+	{
+		int zone;
+		Clock::time_point start;
+		const ImDrawList* drawList;
+		int vertices;
+		int indices;
+		int allocations;
+		int childVertices;
+		int childIndices;
+	};
+
+	Frame& StartFrame(int imguiFrame);
+
+	std::vector<Frame> frames_;
+	int current_ = 0;
+	Clock::time_point frameStart_;
+	std::array<OpenZone, MAX_DEPTH> open_{};
+	int depth_ = 0;
+	int selected_ = 0;  // frames back from the newest
+};
+
+// Times the enclosing scope as a GuiProfiler zone
+class GuiZone
+{
+public:
+	explicit GuiZone(const char* name)
+		: zone_(GuiProfiler::Get().enabled ? GuiProfiler::Get().BeginZone(name) : -1)
+	{
+	}
+
+	~GuiZone()
+	{
+		if (zone_ >= 0)
+		{
+			GuiProfiler::Get().EndZone(zone_);
+		}
+	}
+
+	GuiZone(const GuiZone&) = delete;
+	GuiZone& operator=(const GuiZone&) = delete;
+
+private:
+	int zone_;
+};
@@ -0,0 +1,225 @@
+#include "pch.h"
+#include "HookProfiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+
+int LatencyHistogram::BucketIndex(uint64_t value)
+{
+	if (value < SUB_BUCKETS)
+	{
+		return static_cast<int>(value);
+	}
+	// Keep the top SUB_BUCKET_BITS + 1 bits, the rest only picks the magnitude
+	const int shift = (std::min)(static_cast<int>(std::bit_width(value)) - 1 - SUB_BUCKET_BITS, MAGNITUDES - 1);
+	const auto top = (std::min)(value >> shift, static_cast<uint64_t>(2 * SUB_BUCKETS - 1));
+	return (shift + 1) * SUB_BUCKETS + static_cast<int>(top - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index)
+{
+	if (index < SUB_BUCKETS)
+	{
+		return static_cast<uint64_t>(index);
+	}
+	const int shift = index / SUB_BUCKETS - 1;
+	const uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+	return lower + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds)
+{
+	// Single writer, so plain load/store instead of locked read-modify-writes
+	auto& bucket = buckets_[BucketIndex(nanoseconds)];
+	bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	total_.store(total_.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+	if (nanoseconds > max_.load(std::memory_order_relaxed))
+	{
+		max_.store(nanoseconds, std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::Reset()
+{
+	for (auto& bucket : buckets_)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	count_.store(0, std::memory_order_relaxed);
+	total_.store(0, std::memory_order_relaxed);
+	max_.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::Mean() const
+{
+	const uint64_t count = Count();
+	return count == 0 ? 0.0 : static_cast<double>(Total()) / static_cast<double>(count);
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const
+{
+	const uint64_t count = Count();
+	if (count == 0)
+	{
+		return 0;
+	}
+	const auto target = (std::max)(static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count))), uint64_t{1});
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKETS; ++i)
+	{
+		seen += buckets_[i].load(std::memory_order_relaxed);
+		if (seen >= target)
+		{
+			return (std::min)(BucketUpperBound(i), Max());
+		}
+	}
+	return Max();
+}
+
+HookProfiler::HookProfiler(std::shared_ptr<GameWrapper> gameWrapper) : gameWrapper_(std::move(gameWrapper))
+{
+}
+
+void HookProfiler::HookEvent(const std::string& eventName, std::function<void(std::string)> callback)
+{
+	gameWrapper_->HookEvent(eventName, Wrap(eventName, "", std::move(callback)));
+}
+
+void HookProfiler::HookEventPost(const std::string& eventName, std::function<void(std::string)> callback)
+{
+	gameWrapper_->HookEventPost(eventName, Wrap(eventName, " (post)", std::move(callback)));
+}
+
+HookProfiler::Stats* HookProfiler::GetStats(const std::string& name)
+{
+	std::lock_guard lock(statsMutex_);
+	auto& stats = stats_[name];
+	if (!stats)
+	{
+		stats = std::make_unique<Stats>();
+		stats->eventName = name;
+	}
+	return stats.get();
+}
+
+void HookProfiler::RegisterNotifier(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name, std::filesystem::path defaultCsvPath)
+{
+	cvarManager->registerNotifier(name, [this, defaultCsvPath = std::move(defaultCsvPath)](std::vector<std::string> args)
+	{
+		if (args.size() >= 2 && args[1] == "reset")
+		{
+			Reset();
+			LOG("Hook stats cleared");
+		}
+		else if (args.size() >= 2 && args[1] == "csv")
+		{
+			const std::filesystem::path path = args.size() >= 3 ? std::filesystem::path(args[2]) : defaultCsvPath;
+			if (ExportCsv(path))
+			{
+				LOG("Hook stats written to {}", path.string());
+			}
+			else
+			{
+				WARNLOG("Could not write hook stats to {}", path.string());
+			}
+		}
+		else
+		{
+			PrintToConsole();
+		}
+	}, "Prints hook latency stats. 'csv [file]' exports them, 'reset' clears them", PERMISSION_ALL);
+}
+
+std::vector<const HookProfiler::Stats*> HookProfiler::SortedStats() const
+{
+	std::vector<const Stats*> sorted;
+	{
+		std::lock_guard lock(statsMutex_);
+		sorted.reserve(stats_.size());
+		for (const auto& [name, stats] : stats_)
+		{
+			sorted.push_back(stats.get());
+		}
+	}
+	std::ranges::sort(sorted, [](const Stats* a, const Stats* b) { return a->latency.Total() > b->latency.Total(); });
+	return sorted;
+}
+
+void HookProfiler::PrintToConsole() const
+{
+	LOG("{:>10} {:>10} {:>10} {:>10} {:>10} {:>12}  event", "calls", "mean us", "p50 us", "p99 us", "max us", "total ms");
+	for (const Stats* stats : SortedStats())
+	{
+		const auto& h = stats->latency;
+		LOG("{:>10} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>12.2f}  {}", h.Count(), h.Mean() / 1e3, h.Percentile(50) / 1e3,
+			h.Percentile(99) / 1e3, h.Max() / 1e3, h.Total() / 1e6, stats->eventName);
+	}
+}
+
+void HookProfiler::Render()
+{
+	const auto sorted = SortedStats();
+	if (ImGui::Button("Reset"))
+	{
+		Reset();
+	}
+
+	ImGui::Columns(7, "##hookstats");
+	for (const char* header : {"Event", "Calls", "Mean us", "p50 us", "p99 us", "Max us", "Total ms"})
+	{
+		ImGui::TextUnformatted(header);
+		ImGui::NextColumn();
+	}
+	ImGui::Separator();
+	for (const Stats* stats : sorted)
+	{
+		const auto& h = stats->latency;
+		ImGui::TextUnformatted(stats->eventName.c_str());
+		ImGui::NextColumn();
+		ImGui::Text("%llu", static_cast<unsigned long long>(h.Count()));
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", h.Mean() / 1e3);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", h.Percentile(50) / 1e3);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", h.Percentile(99) / 1e3);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", h.Max() / 1e3);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", h.Total() / 1e6);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+}
+
+bool HookProfiler::ExportCsv(const std::filesystem::path& path) const
+{
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+	std::ofstream out(path);
+	if (!out)
+	{
+		return false;
+	}
+
+	out << "event,calls,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,total_ns\n";
+	for (const Stats* stats : SortedStats())
+	{
+		const auto& h = stats->latency;
+		out << std::format("\"{}\",{},{:.0f},{},{},{},{},{},{}\n", stats->eventName, h.Count(), h.Mean(), h.Percentile(50),
+			h.Percentile(90), h.Percentile(99), h.Percentile(99.9), h.Max(), h.Total());
+	}
+	return static_cast<bool>(out);
+}
+
+void HookProfiler::Reset()
+{
+	std::lock_guard lock(statsMutex_);
+	for (auto& [name, stats] : stats_)
+	{
+		stats->latency.Reset();
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "bakkesmod/wrappers/GameWrapper.h"
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+#include "tracing.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Log-linear histogram of durations in nanoseconds (HDR style): every power of two is split into
+// SUB_BUCKETS linear buckets, so any value is recorded with ~3% precision up to ~34 seconds (2^35 ns).
+// Record is meant to be called from one thread (the game thread), reads from other threads are approximate.
+class LatencyHistogram
+{
+public:
+	static constexpr int SUB_BUCKET_BITS = 5;
+	static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static constexpr int MAGNITUDES = 35 - SUB_BUCKET_BITS;
+	static constexpr int BUCKETS = (MAGNITUDES + 1) * SUB_BUCKETS;
+
+	void Record(uint64_t nanoseconds);
+	void Reset();
+
+	[[nodiscard]] uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+	[[nodiscard]] uint64_t Total() const { return total_.load(std::memory_order_relaxed); }
+	[[nodiscard]] uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+	[[nodiscard]] double Mean() const;
+	// percentile in [0, 100]. Returns the upper edge of the bucket the percentile falls in.
+	[[nodiscard]] uint64_t Percentile(double percentile) const;
+
+private:
+	static int BucketIndex(uint64_t value);
+	static uint64_t BucketUpperBound(int index);
+
+	std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+	std::atomic<uint64_t> count_{0};
+	std::atomic<uint64_t> total_{0};
+	std::atomic<uint64_t> max_{0};
+};
+
+// Registers game hooks through GameWrapper and times every invocation of the callback.
+// Use it in place of gameWrapper->HookEvent... and the stats show up in the notifier and Render().
+class HookProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Stats
+	{
+		std::string eventName;
+		LatencyHistogram latency;
+	};
+
+	explicit HookProfiler(std::shared_ptr<GameWrapper> gameWrapper);
+
+	void HookEvent(const std::string& eventName, std::function<void(std::string)> callback);
+	void HookEventPost(const std::string& eventName, std::function<void(std::string)> callback);
+
+	template <typename Caller>
+	void HookEventWithCaller(const std::string& eventName, std::function<void(Caller, void*, std::string)> callback)
+	{
+		gameWrapper_->HookEventWithCaller<Caller>(eventName, Wrap(eventName, "", std::move(callback)));
+	}
+
+	template <typename Caller>
+	void HookEventWithCallerPost(const std::string& eventName, std::function<void(Caller, void*, std::string)> callback)
+	{
+		gameWrapper_->HookEventWithCallerPost<Caller>(eventName, Wrap(eventName, " (post)", std::move(callback)));
+	}
+
+	// The stats for a name, created on first use. The pointer stays valid until the profiler is destroyed,
+	// so code that isn't a hook can time itself into the same table.
+	Stats* GetStats(const std::string& name);
+
+	// `name` prints the table to the console, `name csv [file]` writes it as CSV, `name reset` clears it.
+	void RegisterNotifier(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name, std::filesystem::path defaultCsvPath);
+	// Draws the table. Call from RenderWindow/RenderSettings.
+	void Render();
+
+	bool ExportCsv(const std::filesystem::path& path) const;
+	void Reset();
+
+private:
+	template <typename... Args>
+	std::function<void(Args...)> Wrap(const std::string& eventName, const char* suffix, std::function<void(Args...)> callback)
+	{
+		Stats* stats = GetStats(eventName + suffix);
+		return [stats, callback = std::move(callback)](Args... args)
+		{
+			const auto start = Clock::now();
+			callback(std::move(args)...);
+			const auto end = Clock::now();
+			stats->latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+			tracing::Complete(stats->eventName.c_str(), "hook", start, end);
+		};
+	}
+
+	// Sorted by total time spent, most expensive first
+	std::vector<const Stats*> SortedStats() const;
+	void PrintToConsole() const;
+
+	std::shared_ptr<GameWrapper> gameWrapper_;
+	mutable std::mutex statsMutex_;
+	std::unordered_map<std::string, std::unique_ptr<Stats>> stats_;
+};
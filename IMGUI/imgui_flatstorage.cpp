@@ -0,0 +1,205 @@
+#include "pch.h"
+#include "imgui_flatstorage.h"
+#include "imgui_internal.h"
+
+// Fibonacci hashing, the top bits of the product pick the slot
+static inline ImU32 HomeSlot(ImGuiID key, int shift)
+{
+    return (key * 0x9E3779B1u) >> shift;
+}
+
+const ImGuiFlatStorage::Slot* ImGuiFlatStorage::Find(ImGuiID key) const
+{
+    if (Slots.Size == 0)
+        return NULL;
+    const ImU32 mask = (ImU32)Slots.Size - 1;
+    ImU32 dist = 1;
+    for (ImU32 i = HomeSlot(key, Shift); ; i = (i + 1) & mask, dist++)
+    {
+        const Slot& slot = Slots.Data[i];
+        // Robin Hood keeps every key closer to home than the ones it passed, so a shorter distance ends the search
+        if (slot.dist < dist)
+            return NULL;
+        if (slot.key == key)
+            return &slot;
+    }
+}
+
+ImGuiFlatStorage::Slot* ImGuiFlatStorage::Place(Slot entry)
+{
+    const ImU32 mask = (ImU32)Slots.Size - 1;
+    Slot* placed = NULL;
+    entry.dist = 1;
+    for (ImU32 i = HomeSlot(entry.key, Shift); ; i = (i + 1) & mask, entry.dist++)
+    {
+        Slot& slot = Slots.Data[i];
+        if (slot.dist == 0)
+        {
+            slot = entry;
+            return placed ? placed : &slot;
+        }
+        if (slot.dist < entry.dist)
+        {
+            // Take the slot from the key that is closer to home and carry that one on
+            ImSwap(slot, entry);
+            if (!placed)
+                placed = &slot;
+        }
+    }
+}
+
+void ImGuiFlatStorage::Grow()
+{
+    ImVector<Slot> old;
+    old.swap(Slots);
+    IM_ASSERT(old.Size <= INT_MAX / 2);
+    const int size = old.Size ? old.Size * 2 : 16;
+    Slot empty = {};
+    Slots.resize(size, empty);
+    Shift = 32;
+    for (int bits = size; bits > 1; bits >>= 1)
+        Shift--;
+    for (int i = 0; i < old.Size; i++)
+        if (old.Data[i].dist != 0)
+            Place(old.Data[i]);
+}
+
+ImGuiFlatStorage::Slot* ImGuiFlatStorage::FindOrInsert(ImGuiID key, bool* inserted)
+{
+    if (const Slot* slot = Find(key))
+    {
+        *inserted = false;
+        return const_cast<Slot*>(slot);
+    }
+    // Keep the load under 80%, probe sequences stay short with Robin Hood up to there
+    if ((Count + 1) * 5 > Slots.Size * 4)
+        Grow();
+    Count++;
+    *inserted = true;
+    Slot entry;
+    entry.key = key;
+    entry.dist = 1;
+    entry.val_p = NULL;
+    return Place(entry);
+}
+
+int ImGuiFlatStorage::GetInt(ImGuiID key, int default_val) const
+{
+    const Slot* slot = Find(key);
+    return slot ? slot->val_i : default_val;
+}
+
+void ImGuiFlatStorage::SetInt(ImGuiID key, int val)
+{
+    bool inserted;
+    FindOrInsert(key, &inserted)->val_i = val;
+}
+
+bool ImGuiFlatStorage::GetBool(ImGuiID key, bool default_val) const
+{
+    return GetInt(key, default_val ? 1 : 0) != 0;
+}
+
+void ImGuiFlatStorage::SetBool(ImGuiID key, bool val)
+{
+    SetInt(key, val ? 1 : 0);
+}
+
+float ImGuiFlatStorage::GetFloat(ImGuiID key, float default_val) const
+{
+    const Slot* slot = Find(key);
+    return slot ? slot->val_f : default_val;
+}
+
+void ImGuiFlatStorage::SetFloat(ImGuiID key, float val)
+{
+    bool inserted;
+    FindOrInsert(key, &inserted)->val_f = val;
+}
+
+void* ImGuiFlatStorage::GetVoidPtr(ImGuiID key) const
+{
+    const Slot* slot = Find(key);
+    return slot ? slot->val_p : NULL;
+}
+
+void ImGuiFlatStorage::SetVoidPtr(ImGuiID key, void* val)
+{
+    bool inserted;
+    FindOrInsert(key, &inserted)->val_p = val;
+}
+
+int* ImGuiFlatStorage::GetIntRef(ImGuiID key, int default_val)
+{
+    bool inserted;
+    Slot* slot = FindOrInsert(key, &inserted);
+    if (inserted)
+        slot->val_i = default_val;
+    return &slot->val_i;
+}
+
+bool* ImGuiFlatStorage::GetBoolRef(ImGuiID key, bool default_val)
+{
+    return (bool*)GetIntRef(key, default_val ? 1 : 0);
+}
+
+float* ImGuiFlatStorage::GetFloatRef(ImGuiID key, float default_val)
+{
+    bool inserted;
+    Slot* slot = FindOrInsert(key, &inserted);
+    if (inserted)
+        slot->val_f = default_val;
+    return &slot->val_f;
+}
+
+void** ImGuiFlatStorage::GetVoidPtrRef(ImGuiID key, void* default_val)
+{
+    bool inserted;
+    Slot* slot = FindOrInsert(key, &inserted);
+    if (inserted)
+        slot->val_p = default_val;
+    return &slot->val_p;
+}
+
+void ImGuiFlatStorage::SetAllInt(int val)
+{
+    for (int i = 0; i < Slots.Size; i++)
+        if (Slots.Data[i].dist != 0)
+            Slots.Data[i].val_i = val;
+}
+
+// Runs the tree node against a storage holding just its own state, so ImGuiStorage never has to insert.
+// TreeNodeBehaviorIsOpen() reads it, a click or SetNextItemOpen() writes it, and the result is copied back.
+template <typename Fn>
+static bool WithFlatStorage(ImGuiFlatStorage* storage, const char* label, Fn fn)
+{
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems)
+        return false;
+
+    const ImGuiID id = window->GetID(label);
+    const int stored = storage->GetInt(id, -1);
+    storage->Scratch.Data.resize(0);
+    if (stored != -1)
+        storage->Scratch.SetInt(id, stored);
+
+    ImGuiStorage* window_storage = window->DC.StateStorage;
+    window->DC.StateStorage = &storage->Scratch;
+    const bool open = fn();
+    window->DC.StateStorage = window_storage;
+
+    const int now = storage->Scratch.GetInt(id, -1);
+    if (now != stored)
+        storage->SetInt(id, now);
+    return open;
+}
+
+bool ImGui::TreeNodeEx(ImGuiFlatStorage* storage, const char* label, ImGuiTreeNodeFlags flags)
+{
+    return WithFlatStorage(storage, label, [&] { return TreeNodeEx(label, flags); });
+}
+
+bool ImGui::CollapsingHeader(ImGuiFlatStorage* storage, const char* label, ImGuiTreeNodeFlags flags)
+{
+    return WithFlatStorage(storage, label, [&] { return CollapsingHeader(label, flags); });
+}
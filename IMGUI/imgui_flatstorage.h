@@ -0,0 +1,57 @@
+#pragma once
+#include "imgui.h"
+
+// Key->value storage with the interface of ImGuiStorage, kept in an open addressing hash table (Robin Hood probing)
+// instead of a sorted vector. ImGuiStorage moves every pair after a new key to insert it, which adds up with thousands
+// of tree nodes; inserts and lookups here are O(1) on average.
+//
+// ImGuiStorage itself is left as it is: the ImGuiContext is created by BakkesMod and shared with its own build of
+// ImGui, which reads and writes GImGui->WindowsById and the window storages with the sorted vector layout. Use this
+// for state the plugin owns, and the TreeNodeEx/CollapsingHeader overloads below to keep tree node state in it.
+struct ImGuiFlatStorage
+{
+    // [Internal]
+    struct Slot
+    {
+        ImGuiID key;
+        ImU32   dist;   // 1 + distance from the slot the key hashes to, 0 when empty
+        union { int val_i; float val_f; void* val_p; };
+    };
+
+    ImVector<Slot>      Slots;
+    int                 Count = 0;
+    int                 Shift = 32;
+    ImGuiStorage        Scratch;    // stands in for the window storage while a tree node runs
+
+    void                Clear() { Slots.clear(); Count = 0; Shift = 32; }
+    int                 Size() const { return Count; }
+    IMGUI_API int       GetInt(ImGuiID key, int default_val = 0) const;
+    IMGUI_API void      SetInt(ImGuiID key, int val);
+    IMGUI_API bool      GetBool(ImGuiID key, bool default_val = false) const;
+    IMGUI_API void      SetBool(ImGuiID key, bool val);
+    IMGUI_API float     GetFloat(ImGuiID key, float default_val = 0.0f) const;
+    IMGUI_API void      SetFloat(ImGuiID key, float val);
+    IMGUI_API void*     GetVoidPtr(ImGuiID key) const; // default_val is NULL
+    IMGUI_API void      SetVoidPtr(ImGuiID key, void* val);
+
+    // Same contract as ImGuiStorage: the pointer is valid until the next key is added
+    IMGUI_API int*      GetIntRef(ImGuiID key, int default_val = 0);
+    IMGUI_API bool*     GetBoolRef(ImGuiID key, bool default_val = false);
+    IMGUI_API float*    GetFloatRef(ImGuiID key, float default_val = 0.0f);
+    IMGUI_API void**    GetVoidPtrRef(ImGuiID key, void* default_val = NULL);
+
+    IMGUI_API void      SetAllInt(int val);
+
+private:
+    const Slot*         Find(ImGuiID key) const;
+    Slot*               FindOrInsert(ImGuiID key, bool* inserted);
+    Slot*               Place(Slot entry);
+    void                Grow();
+};
+
+namespace ImGui
+{
+    // Tree nodes that keep their open state in `storage` rather than in the window's ImGuiStorage
+    IMGUI_API bool          TreeNodeEx(ImGuiFlatStorage* storage, const char* label, ImGuiTreeNodeFlags flags = 0);
+    IMGUI_API bool          CollapsingHeader(ImGuiFlatStorage* storage, const char* label, ImGuiTreeNodeFlags flags = 0);
+} // namespace ImGui
@@ -1807,6 +1807,9 @@ namespace ImGui
     // Widgets
     IMGUI_API void          TextEx(const char* text, const char* text_end = NULL, ImGuiTextFlags flags = 0);
     IMGUI_API bool          ButtonEx(const char* label, const ImVec2& size_arg = ImVec2(0,0), ImGuiButtonFlags flags = 0);
+    IMGUI_API bool          ButtonEx(ImGuiID id, const char* label, const ImVec2& size_arg, ImGuiButtonFlags flags);   // id already computed, e.g. by a ImGuiLiteralID
+    IMGUI_API bool          CheckboxEx(ImGuiID id, const char* label, bool* v);
+    IMGUI_API bool          SliderScalarEx(ImGuiID id, const char* label, ImGuiDataType data_type, void* p_data, const void* p_min, const void* p_max, const char* format, float power);
     IMGUI_API bool          CloseButton(ImGuiID id, const ImVec2& pos);
     IMGUI_API bool          CollapseButton(ImGuiID id, const ImVec2& pos);
     IMGUI_API bool          ArrowButtonEx(const char* str_id, ImGuiDir dir, ImVec2 size_arg, ImGuiButtonFlags flags = 0);
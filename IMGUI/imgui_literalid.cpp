@@ -0,0 +1,43 @@
+#include "pch.h"
+#include "imgui_literalid.h"
+#include "imgui_internal.h"
+
+ImGuiID ImGui::GetID(const ImGuiLiteralID& str_id)
+{
+    ImGuiWindow* window = GImGui->CurrentWindow;
+    ImGuiID id = str_id.Hash(window->IDStack.back());
+    KeepAliveID(id);
+    return id;
+}
+
+bool ImGui::Button(const ImGuiLiteralID& label, const ImVec2& size)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems)
+        return false;
+    return ButtonEx(GetID(label), label.Label, size, 0);
+}
+
+bool ImGui::Checkbox(const ImGuiLiteralID& label, bool* v)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems)
+        return false;
+    return CheckboxEx(GetID(label), label.Label, v);
+}
+
+bool ImGui::SliderFloat(const ImGuiLiteralID& label, float* v, float v_min, float v_max, const char* format, float power)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems)
+        return false;
+    return SliderScalarEx(GetID(label), label.Label, ImGuiDataType_Float, v, &v_min, &v_max, format, power);
+}
+
+bool ImGui::TreeNode(const ImGuiLiteralID& label)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems)
+        return false;
+    return TreeNodeBehavior(GetID(label), 0, label.Label, NULL);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "imgui.h"
+
+#include <stddef.h>     // size_t
+
+// Widget IDs for string literal labels, hashed at compile time:
+//
+//     if (ImGui::Button("Save"_id)) ...
+//     ImGui::SliderFloat("Scale##overlay"_id, &scale, 0.5f, 2.0f);
+//
+// ImGuiWindow::GetID() runs ImHashStr over the label every frame, seeded with the top of the ID stack. CRC32 is linear:
+// the hash under any seed is the CRC of the label from a zero register, xor the seed carried through as many zero
+// bytes as were hashed. The CRC is computed at compile time, and so are tables that carry a seed through n zero bytes
+// 4 bits at a time, shared by all literals that hash n bytes. At runtime that leaves 8 lookups for any label length.
+// IDs are identical to ImHashStr, "###" included.
+
+// Polynomials are bit-reflected like the CRC register: bit 31 is x^0
+namespace ImGuiLiteralCrc
+{
+    constexpr ImU32 Poly = 0xEDB88320;
+
+    // a * b mod P
+    consteval ImU32 MultModP(ImU32 a, ImU32 b)
+    {
+        ImU32 p = 0;
+        for (ImU32 m = 1u << 31; m != 0; m >>= 1)
+        {
+            if (a & m)
+                p ^= b;
+            b = (b >> 1) ^ (Poly & (0u - (b & 1)));
+        }
+        return p;
+    }
+
+    // x^(8 * n) mod P: what shifting the register through n zero bytes multiplies it by
+    consteval ImU32 XPow8nModP(size_t n)
+    {
+        ImU32 result = 1u << 31;    // 1
+        ImU32 square = 1u << 23;    // x^8
+        for (; n != 0; n >>= 1)
+        {
+            if (n & 1)
+                result = MultModP(result, square);
+            square = MultModP(square, square);
+        }
+        return result;
+    }
+
+    // Where hashing starts: ImHashStr resets to the seed at every "###"
+    consteval size_t HashStart(const char* label)
+    {
+        size_t start = 0;
+        for (size_t i = 0; label[i] != 0 && label[i + 1] != 0 && label[i + 2] != 0; i++)
+            if (label[i] == '#' && label[i + 1] == '#' && label[i + 2] == '#')
+                start = i;
+        return start;
+    }
+
+    consteval size_t Length(const char* label)
+    {
+        size_t len = 0;
+        while (label[len] != 0)
+            len++;
+        return len;
+    }
+
+    // Data[k][v]: the register (v << 4k) after n zero bytes
+    template<size_t N>
+    struct SeedShift
+    {
+        ImU32 Data[8][16];
+        consteval SeedShift() : Data()
+        {
+            const ImU32 shift = XPow8nModP(N);
+            for (int k = 0; k < 8; k++)
+                for (ImU32 v = 0; v < 16; v++)
+                    Data[k][v] = MultModP(shift, v << (4 * k));
+        }
+    };
+    template<size_t N>
+    inline constexpr SeedShift<N> SeedShiftOf;
+}
+
+struct ImGuiLiteralID
+{
+    const char*     Label;
+    ImU32           Crc;            // CRC register after the hashed part of the label, from 0
+    const ImU32     (*SeedShift)[16];
+
+    // Use "label"_id, which picks the SeedShift table for the label
+    consteval ImGuiLiteralID(const char* label, const ImU32 (*seed_shift)[16]) : Label(label), Crc(0), SeedShift(seed_shift)
+    {
+        for (size_t i = ImGuiLiteralCrc::HashStart(label); label[i] != 0; i++)
+        {
+            Crc ^= (unsigned char)label[i];
+            for (int bit = 0; bit < 8; bit++)
+                Crc = (Crc >> 1) ^ (ImGuiLiteralCrc::Poly & (0u - (Crc & 1)));
+        }
+    }
+
+    // == ImHashStr(Label, 0, seed)
+    ImGuiID         Hash(ImGuiID seed) const
+    {
+        const ImU32 s = ~seed;
+        return ~(Crc ^ SeedShift[0][s & 15] ^ SeedShift[1][(s >> 4) & 15] ^ SeedShift[2][(s >> 8) & 15] ^ SeedShift[3][(s >> 12) & 15] ^
+            SeedShift[4][(s >> 16) & 15] ^ SeedShift[5][(s >> 20) & 15] ^ SeedShift[6][(s >> 24) & 15] ^ SeedShift[7][s >> 28]);
+    }
+};
+
+// One ImGuiLiteralID per distinct literal
+template<size_t N>
+struct ImGuiLiteralString
+{
+    char Data[N];
+    consteval ImGuiLiteralString(const char (&str)[N]) : Data() { for (size_t i = 0; i < N; i++) Data[i] = str[i]; }
+};
+template<ImGuiLiteralString S>
+inline constexpr ImGuiLiteralID ImGuiLiteralIDOf = ImGuiLiteralID(S.Data,
+    ImGuiLiteralCrc::SeedShiftOf<ImGuiLiteralCrc::Length(S.Data) - ImGuiLiteralCrc::HashStart(S.Data)>.Data);
+template<ImGuiLiteralString S>
+consteval const ImGuiLiteralID& operator""_id() { return ImGuiLiteralIDOf<S>; }
+
+namespace ImGui
+{
+    IMGUI_API ImGuiID       GetID(const ImGuiLiteralID& str_id);
+    IMGUI_API bool          Button(const ImGuiLiteralID& label, const ImVec2& size = ImVec2(0,0));
+    IMGUI_API bool          Checkbox(const ImGuiLiteralID& label, bool* v);
+    IMGUI_API bool          SliderFloat(const ImGuiLiteralID& label, float* v, float v_min, float v_max, const char* format = "%.3f", float power = 1.0f);
+    IMGUI_API bool          TreeNode(const ImGuiLiteralID& label);
+} // namespace ImGui
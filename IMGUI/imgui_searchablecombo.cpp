@@ -11,9 +11,12 @@ static float CalcMaxPopupHeightFromItemCount(int items_count)
 }
 
 /* Modified version of BeginCombo from imgui.cpp at line 9172,
- * to include a input field to be able to filter the combo values. */
-bool ImGui::BeginSearchableCombo(const char* label, const char* preview_value, char* input, int input_size, const char* input_preview_value, ImGuiComboFlags flags)
+ * to include a input field to be able to filter the combo values.
+ * id is the hash of label, unused when the window skips its items. */
+static bool BeginSearchableComboEx(ImGuiID id, const char* label, const char* preview_value, char* input, int input_size, const char* input_preview_value, ImGuiComboFlags flags)
 {
+    using namespace ImGui;
+
     // Always consume the SetNextWindowSizeConstraint() call in our early return paths
     ImGuiContext& g = *GImGui;
     bool has_window_size_constraint = (g.NextWindowData.Flags & ImGuiNextWindowDataFlags_HasSizeConstraint) != 0;
@@ -26,7 +29,6 @@ bool ImGui::BeginSearchableCombo(const char* label, const char* preview_value, c
     IM_ASSERT((flags & (ImGuiComboFlags_NoArrowButton | ImGuiComboFlags_NoPreview)) != (ImGuiComboFlags_NoArrowButton | ImGuiComboFlags_NoPreview)); // Can't use both flags together
 
     const ImGuiStyle& style = g.Style;
-    const ImGuiID id = window->GetID(label);
 
     const float arrow_size = (flags & ImGuiComboFlags_NoArrowButton) ? 0.0f : GetFrameHeight();
     const ImVec2 label_size = CalcTextSize(label, NULL, true);
@@ -148,6 +150,12 @@ bool ImGui::BeginSearchableCombo(const char* label, const char* preview_value, c
 }
 
 
+bool ImGui::BeginSearchableCombo(const char* label, const char* preview_value, char* input, int input_size, const char* input_preview_value, ImGuiComboFlags flags)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    return BeginSearchableComboEx(window->SkipItems ? 0 : window->GetID(label), label, preview_value, input, input_size, input_preview_value, flags);
+}
+
 // Just so you can end your BeginSearchableCombo with EndSearchableCombo.
 void ImGui::EndSearchableCombo()
 {
@@ -157,8 +165,10 @@ void ImGui::EndSearchableCombo()
 
 /* Modified version of Combo from imgui.cpp at line 9343,
  * to include a input field to be able to filter the combo values. */
-bool ImGui::SearchableCombo(const char* label, int* current_item, std::vector<std::string> items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items)
+static bool SearchableComboEx(ImGuiID id, const char* label, int* current_item, const std::vector<std::string>& items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items)
 {
+    using namespace ImGui;
+
     ImGuiContext& g = *GImGui;
 
     const char* preview_text = NULL;
@@ -175,7 +185,7 @@ bool ImGui::SearchableCombo(const char* label, int* current_item, std::vector<st
 
     const int input_size = 64;
     char input_buffer[input_size] = "";
-    if (!BeginSearchableCombo(label, preview_text, input_buffer, input_size, input_preview_value, ImGuiComboFlags_None))
+    if (!BeginSearchableComboEx(id, label, preview_text, input_buffer, input_size, input_preview_value, ImGuiComboFlags_None))
         return false;
 
     // Display items
@@ -216,4 +226,16 @@ bool ImGui::SearchableCombo(const char* label, int* current_item, std::vector<st
     EndSearchableCombo();
 
     return value_changed;
+}
+
+bool ImGui::SearchableCombo(const char* label, int* current_item, std::vector<std::string> items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    return SearchableComboEx(window->SkipItems ? 0 : window->GetID(label), label, current_item, items, default_preview_text, input_preview_value, popup_max_height_in_items);
+}
+
+bool ImGui::SearchableCombo(const ImGuiLiteralID& label, int* current_item, std::vector<std::string> items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    return SearchableComboEx(window->SkipItems ? 0 : GetID(label), label.Label, current_item, items, default_preview_text, input_preview_value, popup_max_height_in_items);
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "pch.h"
+#include "JobSystem.h"
+#include "tracing.h"
+
+namespace
+{
+	// Index of the worker running on this thread, so jobs submitted from jobs stay local
+	thread_local const void* currentSystem = nullptr;
+	thread_local unsigned currentWorker = 0;
+}
+
+JobSystem::JobSystem(unsigned workerCount)
+{
+	if (workerCount == 0)
+	{
+		const unsigned hardware = std::thread::hardware_concurrency();
+		workerCount = hardware > 3 ? hardware - 2 : 1;
+	}
+
+	workers_.reserve(workerCount);
+	for (unsigned i = 0; i < workerCount; ++i)
+	{
+		workers_.push_back(std::make_unique<Worker>());
+	}
+	threads_.reserve(workerCount);
+	for (unsigned i = 0; i < workerCount; ++i)
+	{
+		threads_.emplace_back(&JobSystem::WorkerMain, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	stopping_.store(true, std::memory_order_release);
+	available_.release(static_cast<std::ptrdiff_t>(threads_.size()));
+	for (auto& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+void JobSystem::Submit(Job job)
+{
+	unsigned target;
+	if (currentSystem == this)
+	{
+		target = currentWorker;
+	}
+	else
+	{
+		target = nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+	}
+
+	const uint64_t outstanding = outstanding_.fetch_add(1, std::memory_order_relaxed) + 1;
+	tracing::Counter("jobs outstanding", static_cast<int64_t>(outstanding));
+	{
+		std::lock_guard lock(workers_[target]->mutex);
+		workers_[target]->jobs.push_back(std::move(job));
+	}
+	available_.release();
+}
+
+void JobSystem::PostCompletion(Job completion)
+{
+	std::lock_guard lock(completionsMutex_);
+	completions_.push_back(std::move(completion));
+}
+
+size_t JobSystem::DrainCompletions()
+{
+	{
+		std::lock_guard lock(completionsMutex_);
+		if (completions_.empty())
+		{
+			return 0;
+		}
+		draining_.swap(completions_);
+	}
+
+	tracing::Zone zone("job completions", "job");
+	const size_t count = draining_.size();
+	for (auto& completion : draining_)
+	{
+		completion();
+	}
+	draining_.clear();
+	return count;
+}
+
+void JobSystem::WaitIdle()
+{
+	for (uint64_t left = outstanding_.load(std::memory_order_acquire); left != 0; left = outstanding_.load(std::memory_order_acquire))
+	{
+		outstanding_.wait(left, std::memory_order_acquire);
+	}
+}
+
+void JobSystem::WorkerMain(unsigned index)
+{
+	currentSystem = this;
+	currentWorker = index;
+	tracing::SetThreadName("job worker");
+
+	for (;;)
+	{
+		available_.acquire();
+
+		// Every token belongs to a queued job, keep looking until we have it
+		Job job;
+		bool found = false;
+		while (!found)
+		{
+			found = TryPop(index, job) || TrySteal(index, job);
+			if (!found)
+			{
+				if (stopping_.load(std::memory_order_acquire))
+				{
+					return;
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		{
+			tracing::Zone zone("job", "job");
+			// An exception leaving the worker thread would take the game down with it
+			try
+			{
+				job();
+			}
+			catch (const std::exception& e)
+			{
+				ERRORLOG("job failed: {}", e.what());
+			}
+			catch (...)
+			{
+				ERRORLOG("job failed with an unknown exception");
+			}
+		}
+		const uint64_t outstanding = outstanding_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+		tracing::Counter("jobs outstanding", static_cast<int64_t>(outstanding));
+		if (outstanding == 0)
+		{
+			outstanding_.notify_all();
+		}
+	}
+}
+
+bool JobSystem::TryPop(unsigned index, Job& job)
+{
+	Worker& worker = *workers_[index];
+	std::lock_guard lock(worker.mutex);
+	if (worker.jobs.empty())
+	{
+		return false;
+	}
+	// Newest first, its data is most likely still in this core's cache
+	job = std::move(worker.jobs.back());
+	worker.jobs.pop_back();
+	return true;
+}
+
+bool JobSystem::TrySteal(unsigned thief, Job& job)
+{
+	const auto count = static_cast<unsigned>(workers_.size());
+	for (unsigned offset = 1; offset < count; ++offset)
+	{
+		Worker& victim = *workers_[(thief + offset) % count];
+		std::lock_guard lock(victim.mutex);
+		if (victim.jobs.empty())
+		{
+			continue;
+		}
+		// Oldest first, which tends to be the biggest piece of work left
+		job = std::move(victim.jobs.front());
+		victim.jobs.pop_front();
+		stolen_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
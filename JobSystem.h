@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Worker threads for plugin computation that shouldn't run on the game thread (predictions, statistics, file I/O).
+// Every worker has its own deque: it takes its newest job first and steals the oldest jobs of other workers
+// when it runs dry. Results come back through a completion queue that the game thread drains once per tick,
+// so completion handlers can use the SDK wrappers safely.
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	// 0 picks hardware threads - 2 (the game and render threads keep theirs), at least 1.
+	explicit JobSystem(unsigned workerCount = 0);
+	// Finishes the queued jobs and joins the workers. Completions that weren't drained are dropped.
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Callable from any thread, including from inside a job. A job that throws is logged as failed, the other jobs
+	// and WaitIdle() carry on.
+	void Submit(Job job);
+
+	// Runs work() on a worker, then done(result) on the game thread during DrainCompletions.
+	// If work() throws there is no result, done isn't called.
+	template <typename Work, typename Done>
+	void Submit(Work work, Done done)
+	{
+		Submit([this, work = std::move(work), done = std::move(done)]() mutable
+		{
+			if constexpr (std::is_void_v<std::invoke_result_t<Work&>>)
+			{
+				work();
+				PostCompletion(std::move(done));
+			}
+			else
+			{
+				PostCompletion([result = work(), done = std::move(done)]() mutable { done(std::move(result)); });
+			}
+		});
+	}
+
+	// Queues a function for the game thread.
+	void PostCompletion(Job completion);
+	// Runs the queued completions. Call once per tick from the game thread. Returns how many ran.
+	size_t DrainCompletions();
+
+	// Blocks until every submitted job has finished.
+	void WaitIdle();
+
+	[[nodiscard]] unsigned WorkerCount() const { return static_cast<unsigned>(workers_.size()); }
+	[[nodiscard]] uint64_t StolenCount() const { return stolen_.load(std::memory_order_relaxed); }
+
+private:
+	struct alignas(64) Worker
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void WorkerMain(unsigned index);
+	bool TryPop(unsigned index, Job& job);
+	bool TrySteal(unsigned thief, Job& job);
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+	std::vector<std::thread> threads_;
+	// One token per queued job, plus one per worker at shutdown
+	std::counting_semaphore<> available_{0};
+	std::atomic<bool> stopping_{false};
+	std::atomic<unsigned> nextWorker_{0};
+	std::atomic<uint64_t> outstanding_{0};
+	std::atomic<uint64_t> stolen_{0};
+
+	std::mutex completionsMutex_;
+	std::vector<Job> completions_;
+	std::vector<Job> draining_;
+};
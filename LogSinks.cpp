@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "LogSinks.h"
+
+#include <charconv>
+#include <chrono>
+
+namespace
+{
+	constexpr std::string_view LevelName(LogLevel level)
+	{
+		switch (level)
+		{
+		case LogLevel::Trace: return "trace";
+		case LogLevel::Debug: return "debug";
+		case LogLevel::Info: return "info";
+		case LogLevel::Warn: return "warn";
+		case LogLevel::Error: return "error";
+		default: return "";
+		}
+	}
+
+	ImVec4 LevelColor(LogLevel level)
+	{
+		switch (level)
+		{
+		case LogLevel::Trace:
+		case LogLevel::Debug: return {0.6f, 0.6f, 0.6f, 1.0f};
+		case LogLevel::Warn: return {1.0f, 0.8f, 0.3f, 1.0f};
+		case LogLevel::Error: return {1.0f, 0.4f, 0.4f, 1.0f};
+		default: return ImGui::GetStyleColorVec4(ImGuiCol_Text);
+		}
+	}
+
+	std::filesystem::path RotatedPath(const std::filesystem::path& path, int index)
+	{
+		auto rotated = path;
+		rotated.replace_filename(std::format("{}.{}{}", path.stem().string(), index, path.extension().string()));
+		return rotated;
+	}
+}
+
+MappedFileSink::MappedFileSink(std::filesystem::path path, size_t maxFileSize, int maxFiles)
+	: path_(std::move(path)), maxFileSize_(maxFileSize), maxFiles_(maxFiles)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(path_.parent_path(), ec);
+	if (std::filesystem::exists(path_, ec))
+	{
+		Recover(path_);
+		ShiftFiles();
+	}
+	OpenFresh();
+}
+
+MappedFileSink::~MappedFileSink()
+{
+	if (file_.IsOpen())
+	{
+		WriteHeader();
+		file_.Close(offset_);
+	}
+}
+
+void MappedFileSink::Write(LogLevel level, std::string_view text)
+{
+	if (!file_.IsOpen())
+	{
+		return;
+	}
+
+	const auto now = std::chrono::floor<std::chrono::milliseconds>(std::chrono::system_clock::now());
+	const auto line = std::format("{:%F %T} [{}] {}\n", now, LevelName(level), text);
+	if (offset_ + line.size() > file_.Size())
+	{
+		Rotate();
+		if (!file_.IsOpen() || line.size() > file_.Size())
+		{
+			return;
+		}
+	}
+	std::memcpy(file_.Data() + offset_, line.data(), line.size());
+	offset_ += line.size();
+}
+
+void MappedFileSink::Flush()
+{
+	if (!file_.IsOpen())
+	{
+		return;
+	}
+	WriteHeader();
+	// Only starts the write back, the flusher thread doesn't wait for the disk
+	file_.Flush(0, HEADER_SIZE);
+	file_.Flush(flushedUpTo_, offset_ - flushedUpTo_);
+	flushedUpTo_ = offset_;
+}
+
+bool MappedFileSink::OpenFresh()
+{
+	// Still there if it couldn't be renamed, or if no rotated files are kept
+	std::error_code ec;
+	std::filesystem::remove(path_, ec);
+	if (maxFileSize_ <= HEADER_SIZE || !file_.Open(path_, maxFileSize_))
+	{
+		return false;
+	}
+	offset_ = HEADER_SIZE;
+	flushedUpTo_ = 0;
+	WriteHeader();
+	return true;
+}
+
+void MappedFileSink::Rotate()
+{
+	if (file_.IsOpen())
+	{
+		WriteHeader();
+		file_.Close(offset_);
+	}
+	ShiftFiles();
+	OpenFresh();
+}
+
+void MappedFileSink::ShiftFiles()
+{
+	std::error_code ec;
+	std::filesystem::remove(RotatedPath(path_, maxFiles_ - 1), ec);
+	for (int i = maxFiles_ - 2; i >= 1; --i)
+	{
+		std::filesystem::rename(RotatedPath(path_, i), RotatedPath(path_, i + 1), ec);
+	}
+	if (maxFiles_ > 1)
+	{
+		std::filesystem::rename(path_, RotatedPath(path_, 1), ec);
+	}
+}
+
+void MappedFileSink::WriteHeader()
+{
+	char header[HEADER_SIZE];
+	std::memcpy(header, HEADER_PREFIX.data(), HEADER_PREFIX.size());
+	char* digits = header + HEADER_PREFIX.size();
+	std::memset(digits, '0', HEADER_DIGITS);
+	char number[HEADER_DIGITS];
+	const auto end = std::to_chars(number, number + HEADER_DIGITS, offset_).ptr;
+	std::memcpy(digits + HEADER_DIGITS - (end - number), number, end - number);
+	header[HEADER_SIZE - 1] = '\n';
+	std::memcpy(file_.Data(), header, HEADER_SIZE);
+}
+
+void MappedFileSink::Recover(const std::filesystem::path& path)
+{
+	MappedFile file;
+	if (!file.Open(path, 0))
+	{
+		return;
+	}
+	const auto* data = reinterpret_cast<const char*>(file.Data());
+	const size_t size = file.Size();
+
+	// Files without the header were closed by an older version and are fine as they are
+	size_t length = size;
+	if (size >= HEADER_SIZE && std::string_view(data, HEADER_PREFIX.size()) == HEADER_PREFIX)
+	{
+		size_t recorded = 0;
+		const char* digits = data + HEADER_PREFIX.size();
+		if (std::from_chars(digits, digits + HEADER_DIGITS, recorded).ec == std::errc{})
+		{
+			// Lines written after the last flush made it to the page cache too, they end at the first NUL
+			length = (std::clamp)(recorded, HEADER_SIZE, size);
+			while (length < size && data[length] != '\0')
+			{
+				++length;
+			}
+		}
+	}
+	file.Close(length);
+}
+
+MemoryLogSink::MemoryLogSink(size_t capacity) : capacity_(capacity)
+{
+	entries_.reserve(capacity_);
+}
+
+void MemoryLogSink::Write(LogLevel level, std::string_view text)
+{
+	std::lock_guard lock(mutex_);
+	if (entries_.size() < capacity_)
+	{
+		entries_.push_back({level, std::string(text)});
+	}
+	else
+	{
+		entries_[next_] = {level, std::string(text)};
+		next_ = (next_ + 1) % capacity_;
+	}
+	++version_;
+}
+
+void MemoryLogSink::Clear()
+{
+	std::lock_guard lock(mutex_);
+	entries_.clear();
+	next_ = 0;
+	++version_;
+}
+
+std::vector<MemoryLogSink::Entry> MemoryLogSink::Snapshot() const
+{
+	std::lock_guard lock(mutex_);
+	std::vector<Entry> result;
+	result.reserve(entries_.size());
+	result.insert(result.end(), entries_.begin() + next_, entries_.end());
+	result.insert(result.end(), entries_.begin(), entries_.begin() + next_);
+	return result;
+}
+
+void MemoryLogSink::Render(const char* id)
+{
+	ImGui::BeginChild(id, ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
+	{
+		std::lock_guard lock(mutex_);
+		const auto count = static_cast<int>(entries_.size());
+		ImGuiListClipper clipper(count);
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+			{
+				const Entry& entry = entries_[(next_ + i) % entries_.size()];
+				ImGui::PushStyleColor(ImGuiCol_Text, LevelColor(entry.level));
+				ImGui::TextUnformatted(entry.text.data(), entry.text.data() + entry.text.size());
+				ImGui::PopStyleColor();
+			}
+		}
+
+		// Follow new messages unless the user scrolled up
+		if (version_ != renderedVersion_ && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+		{
+			ImGui::SetScrollHereY(1.0f);
+		}
+		renderedVersion_ = version_;
+	}
+	ImGui::EndChild();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "logging.h"
+#include "MappedFile.h"
+
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+// Writes log lines into a memory-mapped file. When the file is full it is renamed to <name>.1<ext>
+// (older ones shift up to maxFiles) and a fresh one is started, the previous session's file is rotated the same way.
+// The file is mapped at its full size, so its first line "# length <n>" says how many bytes are log: it is updated on
+// every flush, and a file left behind by a crash is cut to that length (plus whatever made it out after) when rotated.
+class MappedFileSink final : public logging::LogSink
+{
+public:
+	explicit MappedFileSink(std::filesystem::path path, size_t maxFileSize = 16 * 1024 * 1024, int maxFiles = 3);
+	~MappedFileSink() override;
+
+	void Write(LogLevel level, std::string_view text) override;
+	void Flush() override;
+
+	static constexpr std::string_view HEADER_PREFIX = "# length ";
+	static constexpr size_t HEADER_DIGITS = 12;
+	static constexpr size_t HEADER_SIZE = HEADER_PREFIX.size() + HEADER_DIGITS + 1;
+
+private:
+	bool OpenFresh();
+	void Rotate();
+	// Renames path_ to <name>.1<ext> and shifts the older files up, the oldest is deleted
+	void ShiftFiles();
+	void WriteHeader();
+	// Cuts a file a previous session didn't close to the bytes that were written
+	static void Recover(const std::filesystem::path& path);
+
+	std::filesystem::path path_;
+	size_t maxFileSize_;
+	int maxFiles_;
+	MappedFile file_;
+	size_t offset_ = 0;
+	size_t flushedUpTo_ = 0;
+};
+
+// Keeps the last `capacity` messages in memory so the plugin window can show them.
+class MemoryLogSink final : public logging::LogSink
+{
+public:
+	struct Entry
+	{
+		LogLevel level;
+		std::string text;
+	};
+
+	explicit MemoryLogSink(size_t capacity = 1000);
+
+	void Write(LogLevel level, std::string_view text) override;
+
+	void Clear();
+	// Oldest first.
+	[[nodiscard]] std::vector<Entry> Snapshot() const;
+
+	// Draws the messages as a scrolling child region. Call from RenderWindow/RenderSettings.
+	void Render(const char* id = "##log");
+
+private:
+	mutable std::mutex mutex_;
+	std::vector<Entry> entries_;
+	size_t capacity_;
+	size_t next_ = 0;
+	uint64_t version_ = 0;
+	uint64_t renderedVersion_ = 0;
+};
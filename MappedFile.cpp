@@ -0,0 +1,241 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::filesystem::path& path, size_t size, bool readOnly)
+{
+	Close();
+
+	const DWORD access = readOnly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+	const DWORD creation = readOnly ? OPEN_EXISTING : OPEN_ALWAYS;
+	HANDLE file = CreateFileW(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, creation, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	file_ = file;
+	path_ = path;
+	readOnly_ = readOnly;
+
+	if (size == 0)
+	{
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+		size = static_cast<size_t>(fileSize.QuadPart);
+	}
+
+	if (!Map(size))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close(size_t truncateTo)
+{
+	Unmap();
+	if (file_)
+	{
+		if (!readOnly_ && truncateTo != SIZE_MAX)
+		{
+			LARGE_INTEGER end;
+			end.QuadPart = static_cast<LONGLONG>(truncateTo);
+			if (SetFilePointerEx(file_, end, nullptr, FILE_BEGIN))
+			{
+				SetEndOfFile(file_);
+			}
+		}
+		CloseHandle(file_);
+		file_ = nullptr;
+	}
+	size_ = 0;
+}
+
+bool MappedFile::Resize(size_t size)
+{
+	if (!file_)
+	{
+		return false;
+	}
+	Unmap();
+	return Map(size);
+}
+
+void MappedFile::Flush(size_t offset, size_t length, bool wait) const
+{
+	if (!view_ || offset >= size_ || length == 0)
+	{
+		return;
+	}
+	FlushViewOfFile(view_ + offset, (std::min)(length, size_ - offset));
+	if (wait)
+	{
+		FlushFileBuffers(file_);
+	}
+}
+
+bool MappedFile::Map(size_t size)
+{
+	// Mapping more than the file holds grows it
+	const auto high = static_cast<DWORD>(static_cast<uint64_t>(size) >> 32);
+	const auto low = static_cast<DWORD>(size & 0xFFFFFFFF);
+	mapping_ = CreateFileMappingW(file_, nullptr, readOnly_ ? PAGE_READONLY : PAGE_READWRITE, high, low, nullptr);
+	if (!mapping_)
+	{
+		return false;
+	}
+
+	view_ = static_cast<std::byte*>(MapViewOfFile(mapping_, readOnly_ ? FILE_MAP_READ : FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, size));
+	if (!view_)
+	{
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+		return false;
+	}
+	size_ = size;
+	return true;
+}
+
+void MappedFile::Unmap()
+{
+	if (view_)
+	{
+		UnmapViewOfFile(view_);
+		view_ = nullptr;
+	}
+	if (mapping_)
+	{
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+	}
+}
+#else
+// POSIX, for building the benchmarks and tests on Linux
+
+bool MappedFile::Open(const std::filesystem::path& path, size_t size, bool readOnly)
+{
+	Close();
+
+	const int file = ::open(path.c_str(), readOnly ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	file_ = file;
+	path_ = path;
+	readOnly_ = readOnly;
+
+	if (size == 0)
+	{
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+		size = static_cast<size_t>(status.st_size);
+	}
+
+	if (!Map(size))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close(size_t truncateTo)
+{
+	Unmap();
+	if (file_ >= 0)
+	{
+		if (!readOnly_ && truncateTo != SIZE_MAX)
+		{
+			(void)ftruncate(file_, static_cast<off_t>(truncateTo));
+		}
+		::close(file_);
+		file_ = -1;
+	}
+	size_ = 0;
+}
+
+bool MappedFile::Resize(size_t size)
+{
+	if (file_ < 0)
+	{
+		return false;
+	}
+	Unmap();
+	return Map(size);
+}
+
+void MappedFile::Flush(size_t offset, size_t length, bool wait) const
+{
+	if (!view_ || offset >= size_ || length == 0)
+	{
+		return;
+	}
+	// msync wants a page aligned start
+	const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	const size_t start = offset / page * page;
+	msync(view_ + start, (std::min)(length, size_ - offset) + (offset - start), wait ? MS_SYNC : MS_ASYNC);
+	if (wait)
+	{
+		fsync(file_);
+	}
+}
+
+bool MappedFile::Map(size_t size)
+{
+	struct stat status;
+	if (fstat(file_, &status) != 0)
+	{
+		return false;
+	}
+	// Like CreateFileMapping: mapping more than the file holds grows it, unless it is read only
+	if (static_cast<size_t>(status.st_size) < size && (readOnly_ || ftruncate(file_, static_cast<off_t>(size)) != 0))
+	{
+		return false;
+	}
+
+	void* view = mmap(nullptr, size, readOnly_ ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+	view_ = static_cast<std::byte*>(view);
+	size_ = size;
+	return true;
+}
+
+void MappedFile::Unmap()
+{
+	if (view_)
+	{
+		munmap(view_, size_);
+		view_ = nullptr;
+	}
+}
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// A file mapped into memory as a whole. Writes go to the page cache with a memcpy and reach the disk
+// when the OS gets to them (or on Flush), so the thread writing never waits on a syscall.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Opens or creates the file and maps `size` bytes of it, growing the file if it is shorter.
+	// A size of 0 maps the file at its current length (which must not be 0).
+	bool Open(const std::filesystem::path& path, size_t size, bool readOnly = false);
+	// Unmaps and closes the file. Files opened for writing are cut to `truncateTo` bytes if it is given.
+	void Close(size_t truncateTo = SIZE_MAX);
+	// Maps a different number of bytes, contents are kept. Pointers returned by Data() are invalidated.
+	bool Resize(size_t size);
+	// Starts writing the dirty pages in the range back to disk. wait also flushes the file's metadata.
+	// An empty range does nothing, wait included.
+	void Flush(size_t offset, size_t length, bool wait = false) const;
+
+	[[nodiscard]] std::byte* Data() const { return view_; }
+	[[nodiscard]] size_t Size() const { return size_; }
+	[[nodiscard]] bool IsOpen() const { return view_ != nullptr; }
+	[[nodiscard]] const std::filesystem::path& Path() const { return path_; }
+
+private:
+	bool Map(size_t size);
+	void Unmap();
+
+	std::filesystem::path path_;
+#ifdef _WIN32
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#else
+	int file_ = -1;
+#endif
+	std::byte* view_ = nullptr;
+	size_t size_ = 0;
+	bool readOnly_ = false;
+};
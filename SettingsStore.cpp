@@ -0,0 +1,623 @@
+#include "pch.h"
+#include "SettingsStore.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+	constexpr uint32_t MAGIC = 0x53534D42;  // "BMSS"
+	constexpr uint32_t FORMAT_VERSION = 1;
+	constexpr size_t PAGE = 4096;
+	constexpr size_t INITIAL_SLOTS = 1024;
+	constexpr size_t INITIAL_HEAP = 16 * PAGE;
+
+	uint64_t Hash(std::string_view key)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (const char c : key)
+		{
+			hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	size_t RoundUpToPage(size_t size)
+	{
+		return (size + PAGE - 1) / PAGE * PAGE;
+	}
+
+	// Rebuild writes the new file here and renames it over the store
+	std::filesystem::path TemporaryPath(const std::filesystem::path& path)
+	{
+		auto temporary = path;
+		temporary += ".tmp";
+		return temporary;
+	}
+
+	template <typename T>
+	std::span<const std::byte> AsBytes(const T& value)
+	{
+		return {reinterpret_cast<const std::byte*>(&value), sizeof(T)};
+	}
+
+	template <typename T>
+	std::optional<T> ParseNumber(std::span<const std::byte> text)
+	{
+		const auto* begin = reinterpret_cast<const char*>(text.data());
+		const auto* end = begin + text.size();
+		T value{};
+		const auto [last, ec] = std::from_chars(begin, end, value);
+		if (ec != std::errc() || last != end)
+		{
+			return std::nullopt;
+		}
+		return value;
+	}
+}
+
+struct SettingsStore::Header
+{
+	uint32_t magic;
+	uint32_t formatVersion;
+	uint32_t schemaVersion;
+	uint32_t reserved;
+	uint64_t slotCount;
+	uint64_t used;
+	uint64_t erased;
+	uint64_t heapOffset;
+	uint64_t heapSize;
+	uint64_t heapUsed;
+};
+
+SettingsStore::~SettingsStore()
+{
+	Close();
+}
+
+SettingsStore::Header& SettingsStore::GetHeader() const
+{
+	return *reinterpret_cast<Header*>(file_.Data());
+}
+
+SettingsStore::Slot* SettingsStore::Slots() const
+{
+	return reinterpret_cast<Slot*>(file_.Data() + PAGE);
+}
+
+size_t SettingsStore::SlotCount() const
+{
+	return file_.IsOpen() ? static_cast<size_t>(GetHeader().slotCount) : 0;
+}
+
+bool SettingsStore::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+	// Left behind if the game closed during a Rebuild, the store itself is still the old file
+	std::filesystem::remove(TemporaryPath(path), ec);
+	const auto existingSize = std::filesystem::file_size(path, ec);
+	if (!ec && existingSize > 0)
+	{
+		if (!file_.Open(path, 0))
+		{
+			return false;
+		}
+		const Header& header = GetHeader();
+		if (file_.Size() < PAGE || header.magic != MAGIC || header.formatVersion != FORMAT_VERSION
+			|| !std::has_single_bit(header.slotCount) || header.slotCount > (file_.Size() - PAGE) / sizeof(Slot)
+			|| header.heapOffset != PAGE + header.slotCount * sizeof(Slot)
+			|| header.heapSize > file_.Size() - header.heapOffset || header.heapUsed > header.heapSize)
+		{
+			// Leave the file alone, it may be from a newer version of the plugin
+			WARNLOG("{} is not a settings file this version can read", path.string());
+			file_.Close();
+			return false;
+		}
+		if (!Validate())
+		{
+			WARNLOG("{} is damaged, leaving it as it is", path.string());
+			file_.Close();
+			return false;
+		}
+	}
+	else
+	{
+		if (!file_.Open(path, PAGE + INITIAL_SLOTS * sizeof(Slot) + INITIAL_HEAP))
+		{
+			return false;
+		}
+		Header& header = GetHeader();
+		header = {MAGIC, FORMAT_VERSION, 0, 0, INITIAL_SLOTS, 0, 0, PAGE + INITIAL_SLOTS * sizeof(Slot), INITIAL_HEAP, 0};
+	}
+
+	std::lock_guard lock(mutex_);
+	dirtyPages_.assign(file_.Size() / PAGE / 64 + 1, 0);
+	return true;
+}
+
+void SettingsStore::Close()
+{
+	// Waits for flushes queued with FlushAsync, they use the mapping
+	for (int pending = pendingFlushes_.load(); pending != 0; pending = pendingFlushes_.load())
+	{
+		pendingFlushes_.wait(pending);
+	}
+	if (file_.IsOpen())
+	{
+		Flush();
+		file_.Close();
+	}
+}
+
+uint32_t SettingsStore::SchemaVersion() const
+{
+	return file_.IsOpen() ? GetHeader().schemaVersion : 0;
+}
+
+void SettingsStore::SetSchemaVersion(uint32_t version)
+{
+	if (file_.IsOpen())
+	{
+		GetHeader().schemaVersion = version;
+		MarkDirty(0, sizeof(Header));
+	}
+}
+
+bool SettingsStore::Validate() const
+{
+	const Header& header = GetHeader();
+	uint64_t used = 0;
+	uint64_t erased = 0;
+	for (size_t i = 0; i < SlotCount(); ++i)
+	{
+		const Slot& slot = Slots()[i];
+		if (slot.state == ERASED)
+		{
+			++erased;
+			continue;
+		}
+		if (slot.state == EMPTY)
+		{
+			continue;
+		}
+		if (slot.state != USED || slot.keyLength == 0 || slot.keyLength > MAX_KEY
+			|| slot.type < static_cast<uint8_t>(Type::Int) || slot.type > static_cast<uint8_t>(Type::Bytes))
+		{
+			return false;
+		}
+		if (slot.valueLength > INLINE_VALUE)
+		{
+			uint64_t offset;
+			std::memcpy(&offset, slot.value, sizeof(offset));
+			if (!InHeap(offset, slot.valueLength))
+			{
+				return false;
+			}
+		}
+		++used;
+	}
+	return used == header.used && erased == header.erased;
+}
+
+bool SettingsStore::InHeap(uint64_t offset, uint64_t length) const
+{
+	const Header& header = GetHeader();
+	const uint64_t heapEnd = header.heapOffset + header.heapUsed;
+	return offset >= header.heapOffset && offset <= heapEnd && length <= heapEnd - offset;
+}
+
+const SettingsStore::Slot* SettingsStore::Find(std::string_view key) const
+{
+	const size_t count = SlotCount();
+	if (count == 0)
+	{
+		return nullptr;
+	}
+	const uint64_t hash = Hash(key);
+	const size_t mask = count - 1;
+	const Slot* slots = Slots();
+	for (size_t i = hash & mask, probes = 0; probes < count; i = (i + 1) & mask, ++probes)
+	{
+		const Slot& slot = slots[i];
+		if (slot.state == EMPTY)
+		{
+			return nullptr;
+		}
+		if (slot.state == USED && slot.hash == hash && slot.keyLength == key.size() && std::memcmp(slot.key, key.data(), key.size()) == 0)
+		{
+			return &slot;
+		}
+	}
+	return nullptr;
+}
+
+std::span<const std::byte> SettingsStore::Value(const Slot& slot) const
+{
+	if (slot.valueLength <= INLINE_VALUE)
+	{
+		return {slot.value, slot.valueLength};
+	}
+	uint64_t offset;
+	std::memcpy(&offset, slot.value, sizeof(offset));
+	// Checked on Open already, this catches a slot overwritten through a stale view
+	if (!InHeap(offset, slot.valueLength))
+	{
+		return {};
+	}
+	return {file_.Data() + offset, slot.valueLength};
+}
+
+std::optional<SettingsStore::Type> SettingsStore::GetType(std::string_view key) const
+{
+	const Slot* slot = Find(key);
+	return slot ? std::optional(static_cast<Type>(slot->type)) : std::nullopt;
+}
+
+std::optional<int64_t> SettingsStore::GetInt(std::string_view key) const
+{
+	const Slot* slot = Find(key);
+	if (!slot)
+	{
+		return std::nullopt;
+	}
+	switch (static_cast<Type>(slot->type))
+	{
+	case Type::Int:
+	{
+		int64_t value;
+		std::memcpy(&value, slot->value, sizeof(value));
+		return value;
+	}
+	case Type::Bool:
+		return static_cast<int64_t>(slot->value[0] != std::byte{0});
+	case Type::String:
+		return ParseNumber<int64_t>(Value(*slot));
+	default:
+		return std::nullopt;
+	}
+}
+
+std::optional<double> SettingsStore::GetFloat(std::string_view key) const
+{
+	const Slot* slot = Find(key);
+	if (!slot)
+	{
+		return std::nullopt;
+	}
+	switch (static_cast<Type>(slot->type))
+	{
+	case Type::Float:
+	{
+		double value;
+		std::memcpy(&value, slot->value, sizeof(value));
+		return value;
+	}
+	case Type::Int:
+	{
+		int64_t value;
+		std::memcpy(&value, slot->value, sizeof(value));
+		return static_cast<double>(value);
+	}
+	case Type::String:
+		return ParseNumber<double>(Value(*slot));
+	default:
+		return std::nullopt;
+	}
+}
+
+std::optional<bool> SettingsStore::GetBool(std::string_view key) const
+{
+	const Slot* slot = Find(key);
+	if (slot && static_cast<Type>(slot->type) == Type::Bool)
+	{
+		return slot->value[0] != std::byte{0};
+	}
+	// Cvars store bools as "0"/"1"
+	const auto number = GetInt(key);
+	return number ? std::optional(*number != 0) : std::nullopt;
+}
+
+std::optional<std::string_view> SettingsStore::GetString(std::string_view key) const
+{
+	const Slot* slot = Find(key);
+	if (!slot || static_cast<Type>(slot->type) != Type::String)
+	{
+		return std::nullopt;
+	}
+	const auto value = Value(*slot);
+	return std::string_view(reinterpret_cast<const char*>(value.data()), value.size());
+}
+
+std::optional<std::span<const std::byte>> SettingsStore::GetBytes(std::string_view key) const
+{
+	const Slot* slot = Find(key);
+	if (!slot || (static_cast<Type>(slot->type) != Type::Bytes && static_cast<Type>(slot->type) != Type::String))
+	{
+		return std::nullopt;
+	}
+	return Value(*slot);
+}
+
+bool SettingsStore::SetInt(std::string_view key, int64_t value)
+{
+	return Set(key, Type::Int, AsBytes(value));
+}
+
+bool SettingsStore::SetFloat(std::string_view key, double value)
+{
+	return Set(key, Type::Float, AsBytes(value));
+}
+
+bool SettingsStore::SetBool(std::string_view key, bool value)
+{
+	const uint8_t byte = value ? 1 : 0;
+	return Set(key, Type::Bool, AsBytes(byte));
+}
+
+bool SettingsStore::SetString(std::string_view key, std::string_view value)
+{
+	return Set(key, Type::String, {reinterpret_cast<const std::byte*>(value.data()), value.size()});
+}
+
+bool SettingsStore::SetBytes(std::string_view key, std::span<const std::byte> value)
+{
+	return Set(key, Type::Bytes, value);
+}
+
+bool SettingsStore::Set(std::string_view key, Type type, std::span<const std::byte> value)
+{
+	if (!file_.IsOpen() || key.empty() || key.size() > MAX_KEY || value.size() > UINT32_MAX)
+	{
+		return false;
+	}
+
+	{
+		const Header& header = GetHeader();
+		// Keep the table under 70% full, counting erased slots since they lengthen probes too
+		if ((header.used + header.erased + 1) * 10 > header.slotCount * 7
+			&& !Rebuild(std::bit_ceil(static_cast<size_t>(header.used + 1) * 2), static_cast<size_t>(header.heapSize)))
+		{
+			return false;
+		}
+	}
+	{
+		const Header& header = GetHeader();
+		if (value.size() > INLINE_VALUE && header.heapUsed + value.size() > header.heapSize
+			&& !Rebuild(static_cast<size_t>(header.slotCount), static_cast<size_t>(header.heapSize + value.size()) * 2))
+		{
+			return false;
+		}
+	}
+
+	Header& header = GetHeader();
+	const uint64_t hash = Hash(key);
+	const size_t count = static_cast<size_t>(header.slotCount);
+	const size_t mask = count - 1;
+	Slot* slots = Slots();
+	Slot* target = nullptr;
+	for (size_t i = hash & mask, probes = 0; probes < count; i = (i + 1) & mask, ++probes)
+	{
+		Slot& slot = slots[i];
+		if (slot.state == USED && slot.hash == hash && slot.keyLength == key.size() && std::memcmp(slot.key, key.data(), key.size()) == 0)
+		{
+			target = &slot;
+			break;
+		}
+		if (slot.state == ERASED && !target)
+		{
+			// Reuse it unless the key turns up further along
+			target = &slot;
+		}
+		if (slot.state == EMPTY)
+		{
+			target = target ? target : &slot;
+			break;
+		}
+	}
+	if (!target)
+	{
+		// Only with a damaged header, the load factor check keeps empty slots around otherwise
+		return false;
+	}
+
+	if (target->state != USED)
+	{
+		header.erased -= target->state == ERASED ? 1 : 0;
+		++header.used;
+		target->hash = hash;
+		target->keyLength = static_cast<uint16_t>(key.size());
+		std::memset(target->key, 0, MAX_KEY);
+		std::memcpy(target->key, key.data(), key.size());
+		target->state = USED;
+	}
+	target->type = static_cast<uint8_t>(type);
+	target->valueLength = static_cast<uint32_t>(value.size());
+	if (value.size() <= INLINE_VALUE)
+	{
+		std::ranges::copy(value, target->value);
+	}
+	else
+	{
+		// Appended, the old value's bytes stay dead in the heap until the next Rebuild
+		const uint64_t offset = header.heapOffset + header.heapUsed;
+		std::memcpy(file_.Data() + offset, value.data(), value.size());
+		std::memcpy(target->value, &offset, sizeof(offset));
+		header.heapUsed += value.size();
+		MarkDirty(static_cast<size_t>(offset), value.size());
+	}
+
+	MarkDirty(0, sizeof(Header));
+	MarkDirty(static_cast<size_t>(reinterpret_cast<std::byte*>(target) - file_.Data()), sizeof(Slot));
+	return true;
+}
+
+bool SettingsStore::Erase(std::string_view key)
+{
+	auto* slot = const_cast<Slot*>(Find(key));
+	if (!slot)
+	{
+		return false;
+	}
+	// Marked instead of emptied so the probe chains through it stay intact
+	slot->state = ERASED;
+	Header& header = GetHeader();
+	--header.used;
+	++header.erased;
+	MarkDirty(0, sizeof(Header));
+	MarkDirty(static_cast<size_t>(reinterpret_cast<std::byte*>(slot) - file_.Data()), sizeof(Slot));
+	return true;
+}
+
+size_t SettingsStore::Size() const
+{
+	return file_.IsOpen() ? static_cast<size_t>(GetHeader().used) : 0;
+}
+
+bool SettingsStore::Rebuild(size_t slots, size_t heap)
+{
+	struct Entry
+	{
+		std::string key;
+		Type type;
+		std::vector<std::byte> value;
+	};
+	std::vector<Entry> entries;
+	size_t liveHeap = 0;
+	for (size_t i = 0; i < SlotCount(); ++i)
+	{
+		const Slot& slot = Slots()[i];
+		if (slot.state == USED)
+		{
+			const auto value = Value(slot);
+			entries.push_back({std::string(slot.key, slot.keyLength), static_cast<Type>(slot.type), {value.begin(), value.end()}});
+			liveHeap += value.size() > INLINE_VALUE ? value.size() : 0;
+		}
+	}
+
+	slots = std::bit_ceil((std::max)({slots, INITIAL_SLOTS, entries.size() * 2}));
+	heap = RoundUpToPage((std::max)({heap, liveHeap * 2, INITIAL_HEAP}));
+	const uint32_t schemaVersion = GetHeader().schemaVersion;
+	const size_t heapOffset = PAGE + slots * sizeof(Slot);
+
+	// The new table goes into a separate file that replaces the store once it is on disk, so a crash
+	// halfway leaves either the old file or the new one
+	const std::filesystem::path path = file_.Path();
+	const std::filesystem::path temporary = TemporaryPath(path);
+	{
+		std::lock_guard lock(mutex_);
+		FlushPages();
+		file_.Close();
+		std::error_code ec;
+		std::filesystem::remove(temporary, ec);
+		if (!file_.Open(temporary, heapOffset + heap))
+		{
+			ERRORLOG("could not create {}, settings are not saved anymore", temporary.string());
+			ReopenLocked(path);
+			return false;
+		}
+		GetHeader() = {MAGIC, FORMAT_VERSION, schemaVersion, 0, slots, 0, 0, heapOffset, heap, 0};
+		dirtyPages_.assign(file_.Size() / PAGE / 64 + 1, 0);
+	}
+
+	for (const Entry& entry : entries)
+	{
+		Set(entry.key, entry.type, entry.value);
+	}
+
+	std::lock_guard lock(mutex_);
+	file_.Flush(0, file_.Size(), true);
+	file_.Close();
+	std::error_code ec;
+	std::filesystem::rename(temporary, path, ec);
+	if (ec)
+	{
+		ERRORLOG("could not replace {}: {}, settings are not saved anymore", path.string(), ec.message());
+		std::filesystem::remove(temporary, ec);
+	}
+	return ReopenLocked(path) && !ec;
+}
+
+bool SettingsStore::ReopenLocked(const std::filesystem::path& path)
+{
+	dirtyPages_.clear();
+	if (!file_.Open(path, 0))
+	{
+		return false;
+	}
+	dirtyPages_.assign(file_.Size() / PAGE / 64 + 1, 0);
+	return true;
+}
+
+size_t SettingsStore::ImportCvars(const std::shared_ptr<CVarManagerWrapper>& cvarManager, std::span<const std::string> names)
+{
+	size_t imported = 0;
+	for (const std::string& name : names)
+	{
+		if (Find(name))
+		{
+			continue;
+		}
+		CVarWrapper cvar = cvarManager->getCvar(name);
+		if (cvar && SetString(name, cvar.getStringValue()))
+		{
+			++imported;
+		}
+	}
+	return imported;
+}
+
+void SettingsStore::MarkDirty(size_t offset, size_t length)
+{
+	std::lock_guard lock(mutex_);
+	for (size_t page = offset / PAGE; page <= (offset + length - 1) / PAGE && page / 64 < dirtyPages_.size(); ++page)
+	{
+		dirtyPages_[page / 64] |= uint64_t{1} << (page % 64);
+	}
+}
+
+void SettingsStore::Flush()
+{
+	std::lock_guard lock(mutex_);
+	FlushPages();
+}
+
+void SettingsStore::FlushPages()
+{
+	if (!file_.IsOpen())
+	{
+		return;
+	}
+	const size_t pages = file_.Size() / PAGE;
+	size_t runStart = SIZE_MAX;
+	for (size_t page = 0; page <= pages; ++page)
+	{
+		const bool dirty = page < pages && (dirtyPages_[page / 64] >> (page % 64) & 1);
+		if (dirty && runStart == SIZE_MAX)
+		{
+			runStart = page;
+		}
+		else if (!dirty && runStart != SIZE_MAX)
+		{
+			file_.Flush(runStart * PAGE, (page - runStart) * PAGE);
+			runStart = SIZE_MAX;
+		}
+	}
+	std::ranges::fill(dirtyPages_, 0);
+}
+
+void SettingsStore::FlushAsync(JobSystem& jobs)
+{
+	pendingFlushes_.fetch_add(1);
+	jobs.Submit([this]
+	{
+		Flush();
+		pendingFlushes_.fetch_sub(1);
+		pendingFlushes_.notify_all();
+	});
+}
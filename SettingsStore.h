@@ -0,0 +1,143 @@
+#pragma once
+#include "MappedFile.h"
+#include "JobSystem.h"
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Plugin settings in a memory mapped hash table, for configuration that outgrows cvars (bindings, training pack lists,
+// per-map presets). A lookup hashes the key and probes the table in place, Open only checks the slots and a Set only
+// touches the pages of its slot. Flush writes those dirty pages back, FlushAsync does it on a JobSystem worker.
+//
+// Keys are up to MAX_KEY bytes. Values up to INLINE_VALUE bytes are stored in the slot, longer strings and byte blobs
+// in a heap area after the table. Used from one thread (the game thread), except for Flush/FlushAsync.
+class SettingsStore
+{
+public:
+	static constexpr size_t MAX_KEY = 48;
+	static constexpr size_t INLINE_VALUE = 64;
+
+	enum class Type : uint8_t
+	{
+		Int = 1,
+		Float,
+		Bool,
+		String,
+		Bytes,
+	};
+
+	SettingsStore() = default;
+	~SettingsStore();
+
+	SettingsStore(const SettingsStore&) = delete;
+	SettingsStore& operator=(const SettingsStore&) = delete;
+
+	// Opens the store, or creates an empty one if the file doesn't exist
+	bool Open(const std::filesystem::path& path);
+	// Flushes and closes
+	void Close();
+	[[nodiscard]] bool IsOpen() const { return file_.IsOpen(); }
+
+	// For the plugin's own migrations between layouts of its settings, starts at 0
+	[[nodiscard]] uint32_t SchemaVersion() const;
+	void SetSchemaVersion(uint32_t version);
+
+	// Strings that hold a number (cvar imports) are parsed by the number getters
+	[[nodiscard]] std::optional<int64_t> GetInt(std::string_view key) const;
+	[[nodiscard]] std::optional<double> GetFloat(std::string_view key) const;
+	[[nodiscard]] std::optional<bool> GetBool(std::string_view key) const;
+	// Views into the mapping, valid until the next Set or Erase
+	[[nodiscard]] std::optional<std::string_view> GetString(std::string_view key) const;
+	[[nodiscard]] std::optional<std::span<const std::byte>> GetBytes(std::string_view key) const;
+	[[nodiscard]] std::optional<Type> GetType(std::string_view key) const;
+
+	// Return false if the key is too long or the file can't grow
+	bool SetInt(std::string_view key, int64_t value);
+	bool SetFloat(std::string_view key, double value);
+	bool SetBool(std::string_view key, bool value);
+	bool SetString(std::string_view key, std::string_view value);
+	bool SetBytes(std::string_view key, std::span<const std::byte> value);
+	bool Erase(std::string_view key);
+
+	[[nodiscard]] size_t Size() const;
+
+	// Copies the cvars that aren't in the store yet as strings, so plugins can move their settings over without
+	// users losing them. Returns how many were imported.
+	size_t ImportCvars(const std::shared_ptr<CVarManagerWrapper>& cvarManager, std::span<const std::string> names);
+
+	// Writes the pages changed since the last flush back to the file. Any thread.
+	void Flush();
+	void FlushAsync(JobSystem& jobs);
+
+	// fn(key, type) for every entry, in table order
+	template <typename Fn>
+	void ForEach(Fn&& fn) const
+	{
+		for (size_t i = 0; i < SlotCount(); ++i)
+		{
+			const Slot& slot = Slots()[i];
+			if (slot.state == USED)
+			{
+				fn(std::string_view(slot.key, slot.keyLength), static_cast<Type>(slot.type));
+			}
+		}
+	}
+
+private:
+	enum SlotState : uint8_t
+	{
+		EMPTY = 0,
+		USED = 1,
+		ERASED = 2,
+	};
+
+	struct Slot
+	{
+		uint64_t hash;
+		uint8_t state;
+		uint8_t type;
+		uint16_t keyLength;
+		uint32_t valueLength;
+		char key[MAX_KEY];
+		// The value, or its uint64_t offset into the heap when it is longer than INLINE_VALUE
+		std::byte value[INLINE_VALUE];
+	};
+	static_assert(sizeof(Slot) == 128);
+
+	struct Header;
+
+	[[nodiscard]] Header& GetHeader() const;
+	[[nodiscard]] Slot* Slots() const;
+	[[nodiscard]] size_t SlotCount() const;
+
+	// Checks every slot against the header and the heap, before anything reads through them
+	[[nodiscard]] bool Validate() const;
+	// Whether the bytes are in the used part of the heap
+	[[nodiscard]] bool InHeap(uint64_t offset, uint64_t length) const;
+	[[nodiscard]] const Slot* Find(std::string_view key) const;
+	[[nodiscard]] std::span<const std::byte> Value(const Slot& slot) const;
+	bool Set(std::string_view key, Type type, std::span<const std::byte> value);
+	// Rebuilds the file with room for `slots` entries and `heap` bytes, dropping erased entries and dead heap bytes
+	bool Rebuild(size_t slots, size_t heap);
+	// Maps the file at path again after Rebuild, with mutex_ held
+	bool ReopenLocked(const std::filesystem::path& path);
+	void MarkDirty(size_t offset, size_t length);
+	// Flush with mutex_ held
+	void FlushPages();
+
+	MappedFile file_;
+	// Guards the mapping against a Flush on another thread while it's being remapped, and the dirty page bits
+	mutable std::mutex mutex_;
+	std::vector<uint64_t> dirtyPages_;
+	std::atomic<int> pendingFlushes_{0};
+};
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "StartupPhases.h"
+
+#include <exception>
+
+StartupPhases::StartupPhases(JobSystem& jobs) : jobs_(jobs)
+{
+}
+
+StartupPhases::~StartupPhases()
+{
+	Cancel();
+}
+
+void StartupPhases::Sync(const std::string& name, const std::function<void()>& fn)
+{
+	const auto start = Clock::now();
+	fn();
+	const auto elapsed = Clock::now() - start;
+	Record(name, false, elapsed);
+	std::lock_guard lock(mutex_);
+	syncTime_ += elapsed;
+}
+
+const std::atomic<bool>& StartupPhases::Async(const std::string& name, std::function<void(std::stop_token)> work, std::function<void()> done)
+{
+	std::atomic<bool>& ready = ready_.emplace_back(false);
+	pending_.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard lock(mutex_);
+		++running_;
+		if (!hasAsync_)
+		{
+			hasAsync_ = true;
+			asyncStart_ = Clock::now();
+		}
+	}
+
+	jobs_.Submit([this, name, &ready, work = std::move(work), done = std::move(done)]() mutable
+	{
+		const std::stop_token token = stop_.get_token();
+		if (!token.stop_requested())
+		{
+			const auto start = Clock::now();
+			try
+			{
+				work(token);
+				if (!token.stop_requested())
+				{
+					ready.store(true, std::memory_order_release);
+				}
+			}
+			catch (const std::exception& e)
+			{
+				ERRORLOG("startup task {} failed: {}", name, e.what());
+			}
+			catch (...)
+			{
+				ERRORLOG("startup task {} failed with an unknown exception", name);
+			}
+			Record(name, true, Clock::now() - start);
+			if (ready.load(std::memory_order_relaxed) && done)
+			{
+				jobs_.PostCompletion(std::move(done));
+			}
+		}
+
+		if (!ready.load(std::memory_order_relaxed))
+		{
+			failed_.fetch_add(1, std::memory_order_relaxed);
+		}
+		{
+			std::lock_guard lock(mutex_);
+			asyncEnd_ = Clock::now();
+		}
+		Release();
+
+		// Last use of `this`: once running_ hits 0, Cancel() returns and the owner may destroy this object
+		std::lock_guard lock(mutex_);
+		if (--running_ == 0)
+		{
+			idle_.notify_all();
+		}
+	});
+	return ready;
+}
+
+void StartupPhases::Finish()
+{
+	Release();
+}
+
+void StartupPhases::Cancel()
+{
+	stop_.request_stop();
+	std::unique_lock lock(mutex_);
+	idle_.wait(lock, [this] { return running_ == 0; });
+}
+
+void StartupPhases::Record(std::string name, bool async, Clock::duration elapsed)
+{
+	const double milliseconds = std::chrono::duration<double, std::milli>(elapsed).count();
+	std::lock_guard lock(mutex_);
+	phases_.push_back({std::move(name), async, milliseconds});
+}
+
+void StartupPhases::Release()
+{
+	if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		Report();
+	}
+}
+
+void StartupPhases::Report()
+{
+	std::lock_guard lock(mutex_);
+	const double sync = std::chrono::duration<double, std::milli>(syncTime_).count();
+	if (hasAsync_)
+	{
+		const double async = std::chrono::duration<double, std::milli>(asyncEnd_ - asyncStart_).count();
+		LOG("onLoad: {:.1f} ms sync, {:.1f} ms async{}", sync, async, stop_.stop_requested() ? " (cancelled)" : "");
+	}
+	else
+	{
+		LOG("onLoad: {:.1f} ms sync", sync);
+	}
+	for (const Phase& phase : phases_)
+	{
+		DEBUGLOG("  {:<24} {:>8.2f} ms{}", phase.name, phase.milliseconds, phase.async ? " (async)" : "");
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "JobSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// Splits onLoad into timed phases: what the game needs right away (cvars, notifiers, hooks) runs synchronously,
+// slow initialization (config files, data tables, font atlases) runs on the JobSystem and flips a readiness flag
+// when it's done. Once onLoad has called Finish() and every task has completed, a summary is logged:
+//   onLoad: 3.1 ms sync, 48.0 ms async
+// and the time of each phase at Debug level.
+class StartupPhases
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit StartupPhases(JobSystem& jobs);
+	// Cancels and waits for the tasks that are still running
+	~StartupPhases();
+
+	StartupPhases(const StartupPhases&) = delete;
+	StartupPhases& operator=(const StartupPhases&) = delete;
+
+	// Runs fn now, on the calling thread.
+	void Sync(const std::string& name, const std::function<void()>& fn);
+
+	// Runs work on a worker thread. The returned flag turns true once it has finished (not when it threw or was cancelled),
+	// and stays valid as long as this object. Long running work should return early once the stop token is triggered.
+	// done, if given, runs on the game thread the next time the JobSystem's completions are drained.
+	const std::atomic<bool>& Async(const std::string& name, std::function<void(std::stop_token)> work, std::function<void()> done = {});
+
+	// Marks the end of the synchronous part. Call at the end of onLoad.
+	void Finish();
+
+	// Asks running tasks to stop, skips the ones that haven't started and blocks until none is left. Call from onUnload.
+	void Cancel();
+
+	// Every task has ended and Finish() was called, whether the tasks succeeded or not
+	[[nodiscard]] bool AllFinished() const { return pending_.load(std::memory_order_acquire) == 0; }
+	// Every task has ended and filled in its results: none threw, was cancelled or was skipped
+	[[nodiscard]] bool AllSucceeded() const { return AllFinished() && failed_.load(std::memory_order_acquire) == 0; }
+
+private:
+	struct Phase
+	{
+		std::string name;
+		bool async;
+		double milliseconds;
+	};
+
+	void Record(std::string name, bool async, Clock::duration elapsed);
+	void Release();
+	void Report();
+
+	JobSystem& jobs_;
+	std::stop_source stop_;
+	std::deque<std::atomic<bool>> ready_;
+	// The outstanding tasks, plus one until Finish() is called
+	std::atomic<int> pending_{1};
+	// Tasks that ended without turning their ready flag on
+	std::atomic<int> failed_{0};
+	std::mutex mutex_;
+	int running_ = 0;
+	std::condition_variable idle_;
+	std::vector<Phase> phases_;
+	Clock::duration syncTime_{};
+	Clock::time_point asyncStart_{};
+	Clock::time_point asyncEnd_{};
+	bool hasAsync_ = false;
+};
@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "StateHandoff.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	constexpr uint32_t MAGIC = 0x4F484D42;  // "BMHO"
+	constexpr uint32_t FORMAT_VERSION = 1;
+	constexpr char CVAR_SECTION[] = "cvars";
+
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t formatVersion;
+		int64_t savedAt;  // seconds since the epoch
+		uint32_t sectionCount;
+	};
+}
+
+StateHandoff::StateHandoff(std::filesystem::path path, std::chrono::seconds maxAge) : path_(std::move(path)), maxAge_(maxAge)
+{
+}
+
+bool StateHandoff::Load()
+{
+	blob_.clear();
+	sections_.clear();
+
+	std::error_code ec;
+	const auto size = std::filesystem::file_size(path_, ec);
+	if (ec)
+	{
+		return false;
+	}
+	{
+		std::ifstream in(path_, std::ios::binary);
+		blob_.resize(static_cast<size_t>(size));
+		if (!in.read(reinterpret_cast<char*>(blob_.data()), static_cast<std::streamsize>(blob_.size())))
+		{
+			blob_.clear();
+		}
+	}
+	// One shot: if the plugin crashes before the next unload, the load after that starts clean
+	std::filesystem::remove(path_, ec);
+
+	BlobReader reader(blob_);
+	FileHeader header{};
+	if (!reader.Read(header) || header.magic != MAGIC || header.formatVersion != FORMAT_VERSION)
+	{
+		blob_.clear();
+		return false;
+	}
+	const auto savedAt = std::chrono::system_clock::time_point(std::chrono::seconds(header.savedAt));
+	if (std::chrono::system_clock::now() - savedAt > maxAge_)
+	{
+		DEBUGLOG("handoff state in {} is too old, starting clean", path_.string());
+		blob_.clear();
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header.sectionCount; ++i)
+	{
+		std::string name;
+		Section section{};
+		uint64_t sectionSize = 0;
+		if (!reader.Read(name) || !reader.Read(section.version) || !reader.Read(sectionSize)
+			|| sectionSize > blob_.size() || !reader.ReadBytes(static_cast<size_t>(sectionSize), section.data))
+		{
+			WARNLOG("handoff state in {} is truncated, {} of {} sections restored", path_.string(), i, header.sectionCount);
+			break;
+		}
+		sections_[std::move(name)] = section;
+	}
+	return !sections_.empty();
+}
+
+void StateHandoff::Register(const std::string& name, uint32_t version, SaveFn save)
+{
+	for (auto& [registered, registration] : registrations_)
+	{
+		if (registered == name)
+		{
+			registration = {version, std::move(save)};
+			return;
+		}
+	}
+	registrations_.emplace_back(name, Registration{version, std::move(save)});
+}
+
+std::optional<BlobReader> StateHandoff::Restore(const std::string& name, uint32_t version) const
+{
+	const auto it = sections_.find(name);
+	if (it == sections_.end() || it->second.version != version)
+	{
+		return std::nullopt;
+	}
+	return BlobReader(it->second.data);
+}
+
+void StateHandoff::RegisterCvars(std::shared_ptr<CVarManagerWrapper> cvarManager, std::vector<std::string> names)
+{
+	if (auto in = Restore(CVAR_SECTION, 1))
+	{
+		std::string name, value;
+		while (in->Read(name) && in->Read(value))
+		{
+			if (std::ranges::find(names, name) == names.end())
+			{
+				continue;
+			}
+			if (CVarWrapper cvar = cvarManager->getCvar(name))
+			{
+				cvar.setValue(value);
+			}
+		}
+	}
+
+	cvarManager_ = std::move(cvarManager);
+	cvarNames_.insert(cvarNames_.end(), std::make_move_iterator(names.begin()), std::make_move_iterator(names.end()));
+}
+
+bool StateHandoff::Save()
+{
+	std::vector<std::pair<std::string, BlobWriter>> sections;
+	for (const auto& [name, registration] : registrations_)
+	{
+		registration.save(sections.emplace_back(name, BlobWriter()).second);
+	}
+	if (cvarManager_)
+	{
+		BlobWriter& out = sections.emplace_back(CVAR_SECTION, BlobWriter()).second;
+		for (const std::string& name : cvarNames_)
+		{
+			if (CVarWrapper cvar = cvarManager_->getCvar(name))
+			{
+				out.Write(name);
+				out.Write(cvar.getStringValue());
+			}
+		}
+	}
+
+	BlobWriter out;
+	const auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+	out.Write(FileHeader{MAGIC, FORMAT_VERSION, now.count(), static_cast<uint32_t>(sections.size())});
+	for (size_t i = 0; i < sections.size(); ++i)
+	{
+		const auto& [name, section] = sections[i];
+		// The cvar section is the last one and always version 1
+		out.Write(name);
+		out.Write(i < registrations_.size() ? registrations_[i].second.version : uint32_t{1});
+		out.Write(static_cast<uint64_t>(section.Data().size()));
+		out.WriteBytes(section.Data());
+	}
+
+	// Written next to the target and renamed, so a half written file is never loaded
+	std::error_code ec;
+	std::filesystem::create_directories(path_.parent_path(), ec);
+	std::filesystem::path temporary = path_;
+	temporary += ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file.write(reinterpret_cast<const char*>(out.Data().data()), static_cast<std::streamsize>(out.Data().size())))
+		{
+			WARNLOG("could not write handoff state to {}", temporary.string());
+			return false;
+		}
+	}
+	std::filesystem::rename(temporary, path_, ec);
+	if (ec)
+	{
+		WARNLOG("could not write handoff state to {}: {}", path_.string(), ec.message());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Values that are stored as their bytes. Pointers make no sense in a blob that outlives the DLL.
+template <typename T>
+concept Blittable = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !std::is_array_v<T> && !std::is_same_v<T, std::string_view>;
+
+// Appends values to a state blob: trivially copyable values, strings and vectors of trivially copyable values.
+// The blob is read back by the same plugin on the same machine, so there is no endianness or padding to care about.
+class BlobWriter
+{
+public:
+	template <Blittable T>
+	void Write(const T& value)
+	{
+		const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+		data_.insert(data_.end(), bytes, bytes + sizeof(T));
+	}
+
+	void Write(std::string_view text)
+	{
+		Write(static_cast<uint64_t>(text.size()));
+		const auto* bytes = reinterpret_cast<const std::byte*>(text.data());
+		data_.insert(data_.end(), bytes, bytes + text.size());
+	}
+
+	template <Blittable T>
+	void Write(const std::vector<T>& values)
+	{
+		Write(static_cast<uint64_t>(values.size()));
+		const auto* bytes = reinterpret_cast<const std::byte*>(values.data());
+		data_.insert(data_.end(), bytes, bytes + values.size() * sizeof(T));
+	}
+
+	void WriteBytes(std::span<const std::byte> bytes)
+	{
+		data_.insert(data_.end(), bytes.begin(), bytes.end());
+	}
+
+	[[nodiscard]] const std::vector<std::byte>& Data() const { return data_; }
+
+private:
+	std::vector<std::byte> data_;
+};
+
+// Reads a blob written by BlobWriter in the same order. Every Read returns false once the blob runs out,
+// so a section can be read with one chained condition and dropped as a whole when it doesn't match.
+class BlobReader
+{
+public:
+	explicit BlobReader(std::span<const std::byte> data) : data_(data) {}
+
+	template <Blittable T>
+	bool Read(T& value)
+	{
+		if (data_.size() < sizeof(T))
+		{
+			return false;
+		}
+		std::memcpy(&value, data_.data(), sizeof(T));
+		data_ = data_.subspan(sizeof(T));
+		return true;
+	}
+
+	bool Read(std::string& text)
+	{
+		uint64_t size = 0;
+		if (!Read(size) || data_.size() < size)
+		{
+			return false;
+		}
+		text.assign(reinterpret_cast<const char*>(data_.data()), static_cast<size_t>(size));
+		data_ = data_.subspan(static_cast<size_t>(size));
+		return true;
+	}
+
+	template <Blittable T>
+	bool Read(std::vector<T>& values)
+	{
+		uint64_t count = 0;
+		if (!Read(count) || data_.size() / sizeof(T) < count)
+		{
+			return false;
+		}
+		values.resize(static_cast<size_t>(count));
+		std::memcpy(values.data(), data_.data(), values.size() * sizeof(T));
+		data_ = data_.subspan(values.size() * sizeof(T));
+		return true;
+	}
+
+	// Takes the next `size` bytes as they are
+	bool ReadBytes(size_t size, std::span<const std::byte>& bytes)
+	{
+		if (data_.size() < size)
+		{
+			return false;
+		}
+		bytes = data_.first(size);
+		data_ = data_.subspan(size);
+		return true;
+	}
+
+	[[nodiscard]] bool AtEnd() const { return data_.empty(); }
+
+private:
+	std::span<const std::byte> data_;
+};
+
+// Carries plugin state across an unload/load cycle, so reloading during development doesn't redo the slow parts of onLoad.
+// onUnload saves every registered section into a file in the data folder; the next onLoad picks it up and deletes it.
+// A file older than maxAge is ignored, so starting the game the next day still gets a clean start.
+//
+//   handoff = std::make_unique<StateHandoff>(gameWrapper->GetDataFolder() / "myplugin" / "handoff.bin");
+//   handoff->Load();
+//   handoff->Register("tables", 2, [this](BlobWriter& out) { out.Write(table); });
+//   if (auto in = handoff->Restore("tables", 2); !in || !in->Read(table)) { table = ParseTables(); }
+//   ...
+//   void onUnload() { handoff->Save(); }
+//
+// Bump a section's version whenever its layout changes, a section saved with another version is not restored.
+class StateHandoff
+{
+public:
+	using SaveFn = std::function<void(BlobWriter&)>;
+
+	explicit StateHandoff(std::filesystem::path path, std::chrono::seconds maxAge = std::chrono::minutes(2));
+
+	// Reads and deletes the state left by the previous unload. Returns whether there was any.
+	bool Load();
+
+	// save is called by Save(). Registering a name again replaces the previous function.
+	void Register(const std::string& name, uint32_t version, SaveFn save);
+	// The section's data from the previous unload, if it was saved with the same version.
+	[[nodiscard]] std::optional<BlobReader> Restore(const std::string& name, uint32_t version) const;
+
+	// Call right after registering the cvars: sets them to their values from before the reload,
+	// and saves their current values on the next Save().
+	void RegisterCvars(std::shared_ptr<CVarManagerWrapper> cvarManager, std::vector<std::string> names);
+
+	// Writes every registered section. Call from onUnload.
+	bool Save();
+
+	[[nodiscard]] bool Restored() const { return !sections_.empty(); }
+
+private:
+	struct Registration
+	{
+		uint32_t version;
+		SaveFn save;
+	};
+
+	struct Section
+	{
+		uint32_t version;
+		std::span<const std::byte> data;  // in blob_
+	};
+
+	std::filesystem::path path_;
+	std::chrono::seconds maxAge_;
+	std::vector<std::byte> blob_;
+	std::unordered_map<std::string, Section> sections_;
+	std::vector<std::pair<std::string, Registration>> registrations_;
+	std::shared_ptr<CVarManagerWrapper> cvarManager_;
+	std::vector<std::string> cvarNames_;
+};
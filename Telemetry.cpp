@@ -0,0 +1,372 @@
+#include "pch.h"
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+	using namespace telemetry;
+
+	constexpr uint32_t MAGIC = 0x4C544D42;  // "BMTL"
+	constexpr uint32_t VERSION = 1;
+	constexpr size_t HEADER_SIZE = 256;
+
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t objects;
+		uint32_t channels;
+		uint32_t recordSize;
+		uint32_t keyframeInterval;
+		uint64_t frameCount;
+		uint64_t slotCount;
+		// 0 until the recording is closed
+		uint64_t indexOffset;
+		uint64_t indexCount;
+		float scales[GameStateHistory::CHANNELS];
+	};
+	static_assert(sizeof(FileHeader) <= HEADER_SIZE);
+
+	enum RecordKind : uint8_t
+	{
+		UNWRITTEN = 0,
+		DELTA = 1,
+		KEYFRAME = 2,
+	};
+
+	struct RecordHeader
+	{
+		float time;
+		uint8_t carCount;
+		uint8_t kind;
+		uint16_t reserved;
+		uint64_t pads;
+	};
+
+	constexpr size_t DELTA_SIZE = sizeof(RecordHeader) + VALUES * sizeof(int16_t);
+	constexpr size_t RECORD_SIZE = DELTA_SIZE;
+	// A keyframe takes two slots
+	static_assert(sizeof(RecordHeader) + VALUES * sizeof(int32_t) <= 2 * RECORD_SIZE);
+
+	// Quantization steps per unit of each channel
+	constexpr float SCALES[GameStateHistory::CHANNELS] = {
+		50.0f, 50.0f, 50.0f,        // position, 1/50 uu
+		10.0f, 10.0f, 10.0f,        // velocity, 0.1 uu/s
+		1000.0f, 1000.0f, 1000.0f,  // angular velocity, 0.001 rad/s
+		10000.0f,                   // boost
+	};
+
+	constexpr size_t INITIAL_SLOTS = 64 * 1024;  // ~10 minutes at 120 Hz
+
+	int32_t Quantize(float value, int channel)
+	{
+		const float scaled = value * SCALES[channel];
+		// Also turns NaN into 0
+		if (!(std::fabs(scaled) < 2e9f))
+		{
+			return 0;
+		}
+		return static_cast<int32_t>(std::lround(scaled));
+	}
+
+	size_t SlotOffset(uint64_t slot)
+	{
+		return HEADER_SIZE + static_cast<size_t>(slot) * RECORD_SIZE;
+	}
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+	Close();
+}
+
+bool TelemetryRecorder::Open(const std::filesystem::path& path)
+{
+	Close();
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+	std::filesystem::remove(path, ec);
+	if (!file_.Open(path, SlotOffset(INITIAL_SLOTS)))
+	{
+		return false;
+	}
+
+	FileHeader header{};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.objects = GameStateHistory::OBJECTS;
+	header.channels = GameStateHistory::CHANNELS;
+	header.recordSize = RECORD_SIZE;
+	header.keyframeInterval = KEYFRAME_INTERVAL;
+	std::memcpy(header.scales, SCALES, sizeof(SCALES));
+	std::memcpy(file_.Data(), &header, sizeof(header));
+
+	frames_ = 0;
+	slots_ = 0;
+	lastHistoryTick_ = ~0ull;
+	index_.clear();
+	return true;
+}
+
+void TelemetryRecorder::Close()
+{
+	if (!file_.IsOpen())
+	{
+		return;
+	}
+
+	const size_t indexOffset = SlotOffset(slots_);
+	const size_t end = indexOffset + index_.size() * sizeof(IndexEntry);
+	if (end <= file_.Size() || file_.Resize(end))
+	{
+		std::memcpy(file_.Data() + indexOffset, index_.data(), index_.size() * sizeof(IndexEntry));
+		WriteCounts();
+		const uint64_t offset = indexOffset;
+		const uint64_t count = index_.size();
+		std::memcpy(file_.Data() + offsetof(FileHeader, indexOffset), &offset, sizeof(offset));
+		std::memcpy(file_.Data() + offsetof(FileHeader, indexCount), &count, sizeof(count));
+		file_.Close(end);
+	}
+	else
+	{
+		// Without room for the index the reader rebuilds it
+		file_.Close(indexOffset);
+	}
+}
+
+bool TelemetryRecorder::Reserve(uint64_t slots)
+{
+	const size_t needed = SlotOffset(slots_ + slots);
+	if (needed <= file_.Size())
+	{
+		return true;
+	}
+	// Remapping is the one expensive step, so grow by half the file each time
+	return file_.Resize((std::max)(needed, file_.Size() + file_.Size() / 2));
+}
+
+void TelemetryRecorder::WriteCounts()
+{
+	std::memcpy(file_.Data() + offsetof(FileHeader, frameCount), &frames_, sizeof(frames_));
+	std::memcpy(file_.Data() + offsetof(FileHeader, slotCount), &slots_, sizeof(slots_));
+}
+
+void TelemetryRecorder::Capture(const GameStateHistory& history)
+{
+	const uint64_t end = history.End();
+	if (end == 0 || end - 1 == lastHistoryTick_)
+	{
+		return;
+	}
+	const uint64_t tick = end - 1;
+
+	TelemetryFrame frame;
+	bool ok = history.CopyTimes(tick, {&frame.time, 1})
+		&& history.CopyCarCounts(tick, {&frame.carCount, 1})
+		&& history.CopyPads(tick, {&frame.pads, 1});
+	for (int object = 0; ok && object < GameStateHistory::OBJECTS; ++object)
+	{
+		for (int channel = 0; ok && channel < GameStateHistory::CHANNELS; ++channel)
+		{
+			ok = history.Copy(object, static_cast<GameStateHistory::Channel>(channel), tick, {&frame.values[object][channel], 1});
+		}
+	}
+	if (ok)
+	{
+		lastHistoryTick_ = tick;
+		Append(frame);
+	}
+}
+
+void TelemetryRecorder::Append(const TelemetryFrame& frame)
+{
+	if (!file_.IsOpen())
+	{
+		return;
+	}
+
+	int32_t quantized[VALUES];
+	int16_t deltas[VALUES];
+	bool keyframe = frames_ % KEYFRAME_INTERVAL == 0;
+	for (int i = 0; i < VALUES; ++i)
+	{
+		quantized[i] = Quantize(frame.values[i / GameStateHistory::CHANNELS][i % GameStateHistory::CHANNELS], i % GameStateHistory::CHANNELS);
+		const int64_t delta = static_cast<int64_t>(quantized[i]) - previous_[i];
+		if (delta < INT16_MIN || delta > INT16_MAX)
+		{
+			keyframe = true;
+		}
+		deltas[i] = static_cast<int16_t>(delta);
+	}
+
+	const uint64_t slots = keyframe ? 2 : 1;
+	if (!Reserve(slots))
+	{
+		ERRORLOG("telemetry: could not grow {}, recording stopped", file_.Path().string());
+		// The mapping is gone, so there is no writing the index. The reader rebuilds it.
+		file_.Close(SlotOffset(slots_));
+		return;
+	}
+
+	RecordHeader header{frame.time, frame.carCount, keyframe ? KEYFRAME : DELTA, 0, frame.pads};
+	std::byte* record = file_.Data() + SlotOffset(slots_);
+	std::memcpy(record, &header, sizeof(header));
+	if (keyframe)
+	{
+		std::memcpy(record + sizeof(header), quantized, sizeof(quantized));
+		index_.push_back({frames_, slots_});
+	}
+	else
+	{
+		std::memcpy(record + sizeof(header), deltas, sizeof(deltas));
+	}
+	std::memcpy(previous_, quantized, sizeof(quantized));
+
+	++frames_;
+	slots_ += slots;
+	WriteCounts();
+}
+
+bool TelemetryReader::Open(const std::filesystem::path& path)
+{
+	Close();
+	if (!file_.Open(path, 0, true))
+	{
+		return false;
+	}
+
+	FileHeader header;
+	if (file_.Size() < HEADER_SIZE
+		|| (std::memcpy(&header, file_.Data(), sizeof(header)), header.magic != MAGIC)
+		|| header.version != VERSION
+		|| header.objects != GameStateHistory::OBJECTS
+		|| header.channels != GameStateHistory::CHANNELS
+		|| header.recordSize != RECORD_SIZE
+		|| std::memcmp(header.scales, SCALES, sizeof(SCALES)) != 0)
+	{
+		WARNLOG("telemetry: {} is not a recording this version can read", path.string());
+		Close();
+		return false;
+	}
+
+	const uint64_t slotCount = (std::min)(header.slotCount, static_cast<uint64_t>((file_.Size() - HEADER_SIZE) / RECORD_SIZE));
+	const size_t indexEnd = static_cast<size_t>(header.indexOffset + header.indexCount * sizeof(IndexEntry));
+	if (header.indexOffset == SlotOffset(slotCount) && header.indexCount > 0 && indexEnd <= file_.Size())
+	{
+		index_.resize(static_cast<size_t>(header.indexCount));
+		std::memcpy(index_.data(), file_.Data() + header.indexOffset, index_.size() * sizeof(IndexEntry));
+		frames_ = header.frameCount;
+	}
+	else
+	{
+		RebuildIndex(slotCount);
+	}
+	if (index_.empty() || index_.front().tick != 0)
+	{
+		frames_ = 0;
+	}
+	return true;
+}
+
+void TelemetryReader::Close()
+{
+	file_.Close();
+	index_.clear();
+	frames_ = 0;
+}
+
+void TelemetryReader::RebuildIndex(uint64_t slotCount)
+{
+	// The recording wasn't closed: walk the records until the first one that wasn't written
+	index_.clear();
+	uint64_t tick = 0;
+	uint64_t slot = 0;
+	while (slot < slotCount)
+	{
+		RecordHeader header;
+		std::memcpy(&header, file_.Data() + SlotOffset(slot), sizeof(header));
+		if (header.kind == KEYFRAME && slot + 2 <= slotCount)
+		{
+			index_.push_back({tick, slot});
+			slot += 2;
+		}
+		else if (header.kind == DELTA && !index_.empty())
+		{
+			slot += 1;
+		}
+		else
+		{
+			break;
+		}
+		++tick;
+	}
+	frames_ = tick;
+}
+
+bool TelemetryReader::Read(uint64_t tick, TelemetryFrame& frame) const
+{
+	if (tick >= frames_)
+	{
+		return false;
+	}
+	Cursor cursor;
+	Seek(cursor, tick);
+	frame = cursor.frame;
+	return true;
+}
+
+void TelemetryReader::Seek(Cursor& cursor, uint64_t tick) const
+{
+	const auto keyframe = std::prev(std::upper_bound(index_.begin(), index_.end(), tick,
+		[](uint64_t value, const IndexEntry& entry) { return value < entry.tick; }));
+	cursor.tick = keyframe->tick;
+	cursor.slot = keyframe->slot;
+	Decode(cursor);
+	while (cursor.tick < tick)
+	{
+		Next(cursor);
+	}
+}
+
+void TelemetryReader::Next(Cursor& cursor) const
+{
+	RecordHeader header;
+	std::memcpy(&header, file_.Data() + SlotOffset(cursor.slot), sizeof(header));
+	cursor.slot += header.kind == KEYFRAME ? 2 : 1;
+	++cursor.tick;
+	Decode(cursor);
+}
+
+void TelemetryReader::Decode(Cursor& cursor) const
+{
+	const std::byte* record = file_.Data() + SlotOffset(cursor.slot);
+	RecordHeader header;
+	std::memcpy(&header, record, sizeof(header));
+
+	if (header.kind == KEYFRAME)
+	{
+		std::memcpy(cursor.quantized, record + sizeof(header), sizeof(cursor.quantized));
+	}
+	else
+	{
+		int16_t deltas[VALUES];
+		std::memcpy(deltas, record + sizeof(header), sizeof(deltas));
+		for (int i = 0; i < VALUES; ++i)
+		{
+			cursor.quantized[i] += deltas[i];
+		}
+	}
+
+	cursor.frame.time = header.time;
+	cursor.frame.carCount = header.carCount;
+	cursor.frame.pads = header.pads;
+	for (int i = 0; i < VALUES; ++i)
+	{
+		const int channel = i % GameStateHistory::CHANNELS;
+		cursor.frame.values[i / GameStateHistory::CHANNELS][channel] = static_cast<float>(cursor.quantized[i]) / SCALES[channel];
+	}
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include "GameStateHistory.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+
+// One tick of recorded state, same layout as GameStateHistory
+struct TelemetryFrame
+{
+	float time = 0;
+	uint64_t pads = 0;
+	uint8_t carCount = 0;
+	float values[GameStateHistory::OBJECTS][GameStateHistory::CHANNELS]{};
+};
+
+// Session recordings. Each tick is a fixed size record of 16 bit deltas against the previous tick, quantized per channel
+// (1/50 uu for positions, 0.1 uu/s for velocities). Every KEYFRAME_INTERVAL ticks, and whenever a delta doesn't fit,
+// the tick is stored in full instead (a keyframe, two record slots) and added to the index, which is what seeks go through.
+// The whole file is memory mapped: recording a tick is a memcpy into the page cache, no syscall.
+namespace telemetry
+{
+	constexpr uint32_t KEYFRAME_INTERVAL = 120;
+	constexpr int VALUES = GameStateHistory::OBJECTS * GameStateHistory::CHANNELS;
+
+	struct IndexEntry
+	{
+		uint64_t tick;
+		uint64_t slot;
+	};
+}
+
+class TelemetryRecorder
+{
+public:
+	TelemetryRecorder() = default;
+	~TelemetryRecorder();
+
+	TelemetryRecorder(const TelemetryRecorder&) = delete;
+	TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+	// Starts a new recording, replacing the file
+	bool Open(const std::filesystem::path& path);
+	// Writes the index and cuts the file to its length. A recording that is never closed (game crash) can still
+	// be read, the reader rebuilds the index from the records.
+	void Close();
+	[[nodiscard]] bool IsOpen() const { return file_.IsOpen(); }
+
+	// Records the newest tick of the history, if it wasn't recorded yet. Call after history.Capture.
+	void Capture(const GameStateHistory& history);
+	void Append(const TelemetryFrame& frame);
+
+	[[nodiscard]] uint64_t FrameCount() const { return frames_; }
+
+private:
+	bool Reserve(uint64_t slots);
+	void WriteCounts();
+
+	MappedFile file_;
+	uint64_t frames_ = 0;
+	uint64_t slots_ = 0;
+	uint64_t lastHistoryTick_ = ~0ull;
+	int32_t previous_[telemetry::VALUES]{};
+	std::vector<telemetry::IndexEntry> index_;
+};
+
+class TelemetryReader
+{
+public:
+	bool Open(const std::filesystem::path& path);
+	void Close();
+	[[nodiscard]] bool IsOpen() const { return file_.IsOpen(); }
+
+	[[nodiscard]] uint64_t FrameCount() const { return frames_; }
+
+	// Decodes one tick: a binary search for the keyframe before it, then at most KEYFRAME_INTERVAL deltas.
+	bool Read(uint64_t tick, TelemetryFrame& frame) const;
+
+	// Calls fn(tick, frame) for ticks [first, first + count), decoding straight from the mapping into one reused frame.
+	// Stops early if fn returns false. Returns false if the range isn't in the recording.
+	template <typename Fn>
+	bool Stream(uint64_t first, uint64_t count, Fn&& fn) const
+	{
+		if (count == 0 || first >= frames_ || count > frames_ - first)
+		{
+			return false;
+		}
+		Cursor cursor;
+		Seek(cursor, first);
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			if (i > 0)
+			{
+				Next(cursor);
+			}
+			if constexpr (std::is_same_v<std::invoke_result_t<Fn&, uint64_t, const TelemetryFrame&>, bool>)
+			{
+				if (!fn(cursor.tick, static_cast<const TelemetryFrame&>(cursor.frame)))
+				{
+					break;
+				}
+			}
+			else
+			{
+				fn(cursor.tick, static_cast<const TelemetryFrame&>(cursor.frame));
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] const std::vector<telemetry::IndexEntry>& Index() const { return index_; }
+
+private:
+	struct Cursor
+	{
+		uint64_t tick = 0;
+		uint64_t slot = 0;
+		int32_t quantized[telemetry::VALUES]{};
+		TelemetryFrame frame;
+	};
+
+	void Seek(Cursor& cursor, uint64_t tick) const;
+	void Next(Cursor& cursor) const;
+	// Decodes the record at cursor.slot into the cursor
+	void Decode(Cursor& cursor) const;
+	void RebuildIndex(uint64_t slotCount);
+
+	MappedFile file_;
+	uint64_t frames_ = 0;
+	std::vector<telemetry::IndexEntry> index_;
+};
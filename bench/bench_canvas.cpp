@@ -0,0 +1,167 @@
+// Canvas calls per frame of a training overlay: a ball path, a boost meter and name per car, and a few lines of HUD
+// text. Drawn through CanvasBatch onto CountingCanvas, against the same drawing done call by call the way overlay code
+// does it without the batch (a SetColor and SetPosition per draw). Frames where the overlay is unchanged skip the
+// rebuild; frames where the ball path moves redo it.
+#include "pch.h"
+#include "bench_common.h"
+#include "CanvasBatch.h"
+
+#include <cmath>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	constexpr int CARS = 6;
+	constexpr int PATH_POINTS = 90;
+
+	// Emits the overlay through the CanvasCommands interface, to either a command buffer or a direct adapter
+	template <typename Target>
+	void Overlay(Target& target, int frame)
+	{
+		// Ball path, colored by height band, so the color changes along it
+		for (int i = 1; i < PATH_POINTS; ++i)
+		{
+			const float t0 = static_cast<float>(i - 1 + frame) * 0.1f;
+			const float t1 = static_cast<float>(i + frame) * 0.1f;
+			const float height = std::fabs(std::sin(t1));
+			if (height > 0.66f)
+			{
+				target.SetColor(255, 80, 80);
+			}
+			else if (height > 0.33f)
+			{
+				target.SetColor(255, 200, 0);
+			}
+			else
+			{
+				target.SetColor(80, 255, 80);
+			}
+			target.DrawLine({960 + 400 * std::cos(t0), 540 + 300 * std::sin(t0)}, {960 + 400 * std::cos(t1), 540 + 300 * std::sin(t1)}, 2.0f);
+		}
+
+		// Boost meters: background, fill in the team's color, the amount and the name
+		for (int car = 0; car < CARS; ++car)
+		{
+			const float y = 100.0f + static_cast<float>(car) * 30.0f;
+			target.SetColor(0, 0, 0, 160);
+			target.FillBox({20, y}, {200, 20});
+			if (car < CARS / 2)
+			{
+				target.SetColor(0, 120, 255);
+			}
+			else
+			{
+				target.SetColor(255, 140, 0);
+			}
+			target.FillBox({20, y}, {static_cast<float>(2 * (car * 17 % 100)), 20});
+			target.SetColor(255, 255, 255);
+			target.DrawString({230, y}, "Player " + std::to_string(car + 1), 1.0f, true);
+			target.DrawString({330, y}, std::to_string(car * 17 % 100), 1.0f, true);
+			target.DrawBox({20, y}, {200, 20});
+		}
+
+		target.SetColor(255, 255, 255);
+		for (int line = 0; line < 8; ++line)
+		{
+			target.DrawString({1600, 40.0f + static_cast<float>(line) * 20.0f}, "shot " + std::to_string(line) + ": 87 kph, on target", 1.0f);
+		}
+	}
+
+	// What overlay code without the batch does: state set before every draw
+	struct DirectDrawer
+	{
+		CountingCanvas& canvas;
+		char r = 0, g = 0, b = 0, a = 0;
+
+		void SetColor(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha = 255)
+		{
+			r = static_cast<char>(red), g = static_cast<char>(green), b = static_cast<char>(blue), a = static_cast<char>(alpha);
+		}
+		void DrawLine(Vector2F start, Vector2F end, float width)
+		{
+			canvas.SetColor(r, g, b, a);
+			canvas.DrawLine(start, end, width);
+		}
+		void FillBox(Vector2F position, Vector2F size)
+		{
+			canvas.SetColor(r, g, b, a);
+			canvas.SetPosition(position);
+			canvas.FillBox(size);
+		}
+		void DrawBox(Vector2F position, Vector2F size)
+		{
+			canvas.SetColor(r, g, b, a);
+			canvas.SetPosition(position);
+			canvas.DrawBox(size);
+		}
+		void DrawString(Vector2F position, const std::string& text, float scale, bool dropShadow = false)
+		{
+			canvas.SetColor(r, g, b, a);
+			canvas.SetPosition(position);
+			canvas.DrawString(text, scale, scale, dropShadow, false);
+		}
+	};
+
+	struct Result
+	{
+		double callsPerFrame;
+		std::vector<double> nanoseconds;
+	};
+
+	Result Direct(int frames, bool moving)
+	{
+		Result result{0.0, {}};
+		CountingCanvas canvas;
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			const auto start = bench::Clock::now();
+			DirectDrawer drawer{canvas};
+			Overlay(drawer, moving ? frame : 0);
+			result.nanoseconds.push_back(bench::Elapsed(start));
+		}
+		result.callsPerFrame = static_cast<double>(canvas.Calls()) / frames;
+		return result;
+	}
+
+	Result Batched(int frames, bool moving, CanvasBatch::DrawStats& stats)
+	{
+		Result result{0.0, {}};
+		CountingCanvas canvas;
+		CanvasBatch batch;
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			const auto start = bench::Clock::now();
+			CanvasCommands commands;
+			Overlay(commands, moving ? frame : 0);
+			batch.Submit(0, std::move(commands));
+			batch.Draw(canvas);
+			result.nanoseconds.push_back(bench::Elapsed(start));
+			CHECK(batch.LastStats().rebuilt == (moving || frame == 0));
+		}
+		stats = batch.LastStats();
+		CHECK(stats.canvasCalls * frames == canvas.Calls());
+		result.callsPerFrame = static_cast<double>(canvas.Calls()) / frames;
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int frames = bench::Quick(argc, argv) ? 20 : 20'000;
+
+	for (const bool moving : {false, true})
+	{
+		std::printf("%s overlay\n", moving ? "moving" : "unchanged");
+		Result direct = Direct(frames, moving);
+		CanvasBatch::DrawStats stats;
+		Result batched = Batched(frames, moving, stats);
+		// The batch's own estimate of the unbatched cost has to agree with what direct drawing did
+		CHECK(static_cast<double>(stats.unbatchedCalls) == direct.callsPerFrame);
+		std::printf("  %zu commands, canvas calls per frame: %.0f unbatched, %.0f batched\n", stats.commands, direct.callsPerFrame,
+			batched.callsPerFrame);
+		bench::PrintLatency("  frame, call by call", direct.nanoseconds);
+		bench::PrintLatency("  frame, record + batch", batched.nanoseconds);
+	}
+	return 0;
+}
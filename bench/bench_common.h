@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+#include <vector>
+
+// Shared by the benchmarks and tests. Benchmarks take --quick (what ctest runs: a few iterations, every code path)
+// and print one line per measurement.
+namespace bench
+{
+	using Clock = std::chrono::steady_clock;
+
+	inline bool HasFlag(int argc, char** argv, std::string_view flag)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (argv[i] == flag)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	inline bool Quick(int argc, char** argv)
+	{
+		return HasFlag(argc, argv, "--quick");
+	}
+
+	// Nanoseconds since `start`
+	inline double Elapsed(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+	// CPU time of the calling thread, excludes time spent waiting or preempted
+	inline double ThreadCpuNs()
+	{
+		timespec now{};
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+		return static_cast<double>(now.tv_sec) * 1e9 + static_cast<double>(now.tv_nsec);
+	}
+
+	// Nearest rank, `samples` is sorted in place
+	inline double Percentile(std::vector<double>& samples, double percent)
+	{
+		if (samples.empty())
+		{
+			return 0.0;
+		}
+		std::sort(samples.begin(), samples.end());
+		const auto rank = static_cast<size_t>(percent / 100.0 * static_cast<double>(samples.size()) + 0.5);
+		return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+	}
+
+	// "name: p50 1.23 us, p99 4.56 us, max 7.89 us (n samples)"
+	inline void PrintLatency(const char* name, std::vector<double>& samples)
+	{
+		const double p50 = Percentile(samples, 50);
+		const double p99 = Percentile(samples, 99);
+		std::printf("%-40s p50 %9.3f us  p99 %9.3f us  max %9.3f us  (%zu samples)\n", name, p50 / 1e3, p99 / 1e3,
+			samples.empty() ? 0.0 : samples.back() / 1e3, samples.size());
+	}
+
+	// Keeps the compiler from dropping a computation whose result is unused
+	template <typename T>
+	void DoNotOptimize(const T& value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	// For the tests: prints the failed condition and exits with an error
+	inline void Check(bool condition, const char* what, const char* file, int line)
+	{
+		if (!condition)
+		{
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+			std::exit(1);
+		}
+	}
+}
+
+#define CHECK(condition) bench::Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,88 @@
+// Cost of reading three settings the way a tick handler would: looking the cvars up by name, through CVarWrappers
+// kept from registerCvar, through bindTo variables, and from a CvarCache (Get on the game thread, Snapshot elsewhere).
+// The stand-in keeps values as strings like the game does, so the wrapper reads parse them.
+#include "pch.h"
+#include "bench_common.h"
+#include "CvarCache.h"
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	struct Settings
+	{
+		bool enabled = false;
+		float scale = 1.0f;
+		int mode = 0;
+	};
+
+	template <typename Fn>
+	void Run(const char* name, int reads, Fn&& read)
+	{
+		float sum = 0.0f;
+		const auto start = bench::Clock::now();
+		for (int i = 0; i < reads; ++i)
+		{
+			sum += read();
+		}
+		const double ns = bench::Elapsed(start);
+		bench::DoNotOptimize(sum);
+		std::printf("%-36s %8.2f ns per read of 3 settings\n", name, ns / reads);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int reads = bench::Quick(argc, argv) ? 10'000 : 5'000'000;
+
+	auto cvarManager = std::make_shared<CVarManagerWrapper>();
+	CVarWrapper enabled = cvarManager->registerCvar("bench_enabled", "1", "", true, true, 0, true, 1);
+	CVarWrapper scale = cvarManager->registerCvar("bench_scale", "1.5");
+	CVarWrapper mode = cvarManager->registerCvar("bench_mode", "2");
+	// Filler, so the by-name lookup searches a table the size of a plugin's
+	for (int i = 0; i < 50; ++i)
+	{
+		cvarManager->registerCvar("bench_other_" + std::to_string(i), "0");
+	}
+
+	auto enabledVariable = std::make_shared<bool>();
+	auto scaleVariable = std::make_shared<float>();
+	auto modeVariable = std::make_shared<int>();
+	enabled.bindTo(enabledVariable);
+	scale.bindTo(scaleVariable);
+	mode.bindTo(modeVariable);
+
+	CvarCache<Settings> cache;
+	cache.Bind(&Settings::enabled, enabled);
+	cache.Bind(&Settings::scale, scale);
+	cache.Bind(&Settings::mode, mode);
+
+	mode.setValue(3);
+	CHECK(cache.Get().enabled && cache.Get().scale == 1.5f && cache.Get().mode == 3);
+	CHECK(cache.Snapshot().mode == 3 && *modeVariable == 3);
+
+	Run("getCvar(name).get*Value()", reads, [&]
+	{
+		const bool on = cvarManager->getCvar("bench_enabled").getBoolValue();
+		return on ? cvarManager->getCvar("bench_scale").getFloatValue() * cvarManager->getCvar("bench_mode").getIntValue() : 0.0f;
+	});
+	Run("kept CVarWrapper.get*Value()", reads, [&]
+	{
+		return enabled.getBoolValue() ? scale.getFloatValue() * mode.getIntValue() : 0.0f;
+	});
+	Run("bindTo variables", reads, [&]
+	{
+		return *enabledVariable ? *scaleVariable * *modeVariable : 0.0f;
+	});
+	Run("CvarCache::Get", reads, [&]
+	{
+		const Settings& settings = cache.Get();
+		return settings.enabled ? settings.scale * settings.mode : 0.0f;
+	});
+	Run("CvarCache::Snapshot", reads, [&]
+	{
+		const Settings settings = cache.Snapshot();
+		return settings.enabled ? settings.scale * settings.mode : 0.0f;
+	});
+	return 0;
+}
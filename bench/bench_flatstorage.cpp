@@ -0,0 +1,89 @@
+// ImGuiFlatStorage against ImGuiStorage at 1k and 100k keys: inserting new keys, looking up keys that are there,
+// and keys that aren't. Keys are hashed labels like the IDs of tree nodes, so they arrive in no particular order.
+#include "pch.h"
+#include "bench_common.h"
+#include "IMGUI/imgui_flatstorage.h"
+#include "IMGUI/imgui_internal.h"
+
+#include <random>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	std::vector<ImGuiID> Keys(size_t count, uint32_t seed)
+	{
+		std::vector<ImGuiID> keys(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const std::string label = "node " + std::to_string(i);
+			keys[i] = ImHashStr(label.c_str(), 0, seed);
+		}
+		return keys;
+	}
+
+	template <typename Fn>
+	void Run(const char* storage, const char* operation, size_t keys, int rounds, Fn&& fn)
+	{
+		const auto start = bench::Clock::now();
+		for (int round = 0; round < rounds; ++round)
+		{
+			fn();
+		}
+		const double ns = bench::Elapsed(start) / (static_cast<double>(keys) * rounds);
+		std::printf("%-16s %-8s %7zu keys %9.1f ns per key\n", storage, operation, keys, ns);
+	}
+
+	template <typename Storage>
+	void Measure(const char* name, size_t count, int rounds)
+	{
+		const auto keys = Keys(count, 1);
+		const auto missing = Keys(count, 2);
+		auto shuffled = keys;
+		std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+
+		Storage storage;
+		Run(name, "insert", count, rounds, [&]
+		{
+			storage = Storage();
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				storage.SetInt(keys[i], static_cast<int>(i));
+			}
+		});
+		for (size_t i = 0; i < keys.size(); i += 97)
+		{
+			CHECK(storage.GetInt(keys[i], -1) == static_cast<int>(i));
+		}
+
+		int sum = 0;
+		Run(name, "hit", count, rounds, [&]
+		{
+			for (const ImGuiID key : shuffled)
+			{
+				sum += storage.GetInt(key, -1);
+			}
+		});
+		Run(name, "miss", count, rounds, [&]
+		{
+			for (const ImGuiID key : missing)
+			{
+				sum += storage.GetInt(key, 0);
+			}
+		});
+		bench::DoNotOptimize(sum);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = bench::Quick(argc, argv);
+	for (const size_t count : {size_t{1'000}, size_t{100'000}})
+	{
+		// ImGuiStorage inserts are quadratic, fewer rounds at 100k
+		const int rounds = quick ? 1 : (count == 1'000 ? 200 : 2);
+		Measure<ImGuiFlatStorage>("ImGuiFlatStorage", count, rounds);
+		Measure<ImGuiStorage>("ImGuiStorage", count, rounds);
+	}
+	return 0;
+}
@@ -0,0 +1,181 @@
+// Reload cycle times with StateHandoff: a plugin whose onLoad parses a data table and builds a font atlas is loaded
+// once cold, then unloaded and loaded again repeatedly, restoring both from the handoff file instead.
+// Every cycle gets a fresh CVarManagerWrapper, the way the game drops a plugin's cvars when it unloads.
+#include "pch.h"
+#include "bench_common.h"
+#include "StateHandoff.h"
+
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	struct Entry
+	{
+		uint32_t id;
+		float x, y, z;
+		float weight;
+	};
+
+	struct Atlas
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+	void WriteTable(const std::filesystem::path& path, int rows)
+	{
+		std::ofstream out(path);
+		for (int i = 0; i < rows; ++i)
+		{
+			out << i << ',' << (i % 8192) - 4096 << '.' << i % 100 << ',' << (i * 7 % 10240) - 5120 << ".5," << i % 2044 << ".25," << (i % 1000) / 1000.0 << '\n';
+		}
+	}
+
+	std::vector<Entry> ParseTable(const std::filesystem::path& path)
+	{
+		std::ifstream in(path);
+		std::stringstream text;
+		text << in.rdbuf();
+		std::vector<Entry> table;
+		std::string line;
+		while (std::getline(text, line))
+		{
+			Entry entry{};
+			std::istringstream fields(line);
+			char comma;
+			if (fields >> entry.id >> comma >> entry.x >> comma >> entry.y >> comma >> entry.z >> comma >> entry.weight)
+			{
+				table.push_back(entry);
+			}
+		}
+		return table;
+	}
+
+	Atlas BuildAtlas()
+	{
+		ImFontAtlas fonts;
+		for (float size : {13.0f, 18.0f, 24.0f, 32.0f, 48.0f})
+		{
+			ImFontConfig config;
+			config.SizePixels = size;
+			config.OversampleH = 3;
+			fonts.AddFontDefault(&config);
+		}
+		unsigned char* pixels = nullptr;
+		Atlas atlas;
+		fonts.GetTexDataAsAlpha8(&pixels, &atlas.width, &atlas.height);
+		atlas.pixels.assign(pixels, pixels + static_cast<size_t>(atlas.width) * atlas.height);
+		return atlas;
+	}
+
+	// What a plugin's onLoad/onUnload would do with a handoff
+	class ReloadablePlugin
+	{
+	public:
+		ReloadablePlugin(std::shared_ptr<CVarManagerWrapper> cvarManager, const std::filesystem::path& folder)
+			: cvarManager_(std::move(cvarManager)), folder_(folder), handoff_(folder / "handoff.bin")
+		{
+		}
+
+		void onLoad()
+		{
+			handoff_.Load();
+			cvarManager_->registerCvar("reload_scale", "1.0");
+			cvarManager_->registerCvar("reload_color", "#FFC800");
+			handoff_.RegisterCvars(cvarManager_, {"reload_scale", "reload_color"});
+
+			handoff_.Register("table", 1, [this](BlobWriter& out) { out.Write(table_); });
+			if (auto in = handoff_.Restore("table", 1); !in || !in->Read(table_))
+			{
+				table_ = ParseTable(folder_ / "table.csv");
+			}
+			handoff_.Register("atlas", 1, [this](BlobWriter& out) { out.Write(atlas_.width); out.Write(atlas_.height); out.Write(atlas_.pixels); });
+			if (auto in = handoff_.Restore("atlas", 1); !in || !in->Read(atlas_.width) || !in->Read(atlas_.height) || !in->Read(atlas_.pixels))
+			{
+				atlas_ = BuildAtlas();
+			}
+		}
+
+		void onUnload()
+		{
+			handoff_.Save();
+		}
+
+		const std::vector<Entry>& Table() const { return table_; }
+		const Atlas& GetAtlas() const { return atlas_; }
+
+	private:
+		std::shared_ptr<CVarManagerWrapper> cvarManager_;
+		std::filesystem::path folder_;
+		StateHandoff handoff_;
+		std::vector<Entry> table_;
+		Atlas atlas_;
+	};
+
+	bool Same(const std::vector<Entry>& a, const std::vector<Entry>& b)
+	{
+		return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Entry)) == 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = bench::Quick(argc, argv);
+	const int rows = quick ? 20'000 : 200'000;
+	const int cycles = quick ? 5 : 50;
+
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([](const std::string&) {});
+	const auto folder = std::filesystem::temp_directory_path() / "bakkesmod-bench-handoff";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+	WriteTable(folder / "table.csv", rows);
+
+	std::vector<Entry> coldTable;
+	Atlas coldAtlas;
+	std::vector<double> load;
+	std::vector<double> unload;
+	double coldNs = 0.0;
+	for (int cycle = 0; cycle <= cycles; ++cycle)
+	{
+		auto cvarManager = std::make_shared<CVarManagerWrapper>();
+		ReloadablePlugin plugin(cvarManager, folder);
+		auto start = bench::Clock::now();
+		plugin.onLoad();
+		const double loadNs = bench::Elapsed(start);
+
+		if (cycle == 0)
+		{
+			coldNs = loadNs;
+			coldTable = plugin.Table();
+			coldAtlas = plugin.GetAtlas();
+			CHECK(coldTable.size() == static_cast<size_t>(rows));
+			cvarManager->getCvar("reload_scale").setValue(2.5f);
+		}
+		else
+		{
+			load.push_back(loadNs);
+			CHECK(Same(plugin.Table(), coldTable));
+			CHECK(plugin.GetAtlas().pixels == coldAtlas.pixels && plugin.GetAtlas().width == coldAtlas.width);
+			CHECK(cvarManager->getCvar("reload_scale").getFloatValue() == 2.5f);
+		}
+
+		start = bench::Clock::now();
+		plugin.onUnload();
+		unload.push_back(bench::Elapsed(start));
+	}
+
+	std::printf("%d table rows, %dx%d atlas, %.1f MB handoff file\n", rows, coldAtlas.width, coldAtlas.height,
+		static_cast<double>(std::filesystem::file_size(folder / "handoff.bin")) / 1e6);
+	std::printf("%-40s %9.3f ms\n", "onLoad, cold", coldNs / 1e6);
+	bench::PrintLatency("onLoad, restored from the handoff", load);
+	bench::PrintLatency("onUnload, handoff saved", unload);
+
+	std::filesystem::remove_all(folder);
+	return 0;
+}
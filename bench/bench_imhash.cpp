@@ -0,0 +1,62 @@
+// ImHashStr on label-length strings and ImHashData at 16 B to 4 KB, against the byte-at-a-time CRC32 they replaced.
+// Each hash is seeded with the previous result, so calls can't overlap and the time is their latency.
+#include "pch.h"
+#include "bench_common.h"
+#include "imhash_reference.h"
+#include "IMGUI/imgui_internal.h"
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	template <typename Fn>
+	void Run(const char* name, size_t items, int rounds, Fn&& hash)
+	{
+		ImU32 seed = 0;
+		const auto start = bench::Clock::now();
+		for (int round = 0; round < rounds; ++round)
+		{
+			for (size_t i = 0; i < items; ++i)
+			{
+				seed = hash(i, seed);
+			}
+		}
+		bench::DoNotOptimize(seed);
+		std::printf("%-36s %9.1f ns per hash\n", name, bench::Elapsed(start) / (static_cast<double>(items) * rounds));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int rounds = bench::Quick(argc, argv) ? 10 : 10'000;
+
+	// What a settings window's widgets are called
+	const std::vector<std::string> labels = {
+		"Enable", "Scale##overlay", "Show ball prediction", "Prediction steps", "Line color", "Save", "Reset to defaults",
+		"Training packs", "##search", "Boost pads###pads", "Opacity", "Car 1", "Show speed", "Font size", "Export trace",
+		"Keybind##toggle_overlay", "Log level", "Open data folder", "Advanced", "Ball trail length",
+	};
+	double average = 0.0;
+	for (const auto& label : labels)
+	{
+		average += static_cast<double>(label.size()) / static_cast<double>(labels.size());
+	}
+	std::printf("%zu labels, %.1f bytes on average\n", labels.size(), average);
+
+	Run("ImHashStr, labels", labels.size(), rounds, [&](size_t i, ImU32 seed) { return ImHashStr(labels[i].c_str(), 0, seed); });
+	Run("ImHashStr, labels (before)", labels.size(), rounds, [&](size_t i, ImU32 seed) { return reference::HashStr(labels[i].c_str(), 0, seed); });
+
+	for (const size_t size : {size_t{16}, size_t{64}, size_t{256}, size_t{4096}})
+	{
+		std::vector<unsigned char> data(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			data[i] = static_cast<unsigned char>(i * 31 + 7);
+		}
+		const int dataRounds = (std::max)(1, static_cast<int>(static_cast<size_t>(rounds) * 20 / size));
+		const std::string name = "ImHashData, " + std::to_string(size) + " B";
+		Run(name.c_str(), 1, dataRounds, [&](size_t, ImU32 seed) { return ImHashData(data.data(), size, seed); });
+		Run((name + " (before)").c_str(), 1, dataRounds, [&](size_t, ImU32 seed) { return reference::HashData(data.data(), size, seed); });
+	}
+	return 0;
+}
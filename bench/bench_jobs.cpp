@@ -0,0 +1,100 @@
+// Throughput of JobSystem at 1, 2, 4 and 8 workers: 6 second ball predictions submitted from the game thread with
+// their results drained as completions, and small jobs fanned out from inside jobs so the workers have to steal.
+#include "pch.h"
+#include "bench_common.h"
+#include "BallPrediction.h"
+#include "JobSystem.h"
+
+#include <thread>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	struct Result
+	{
+		double seconds;
+		uint64_t stolen;
+	};
+
+	Result Predictions(unsigned workers, int jobs)
+	{
+		const BallPredictor predictor;
+		JobSystem system(workers);
+		float sum = 0.0f;
+		const auto start = bench::Clock::now();
+		for (int i = 0; i < jobs; ++i)
+		{
+			const BallState ball{{0, 0, 93}, {static_cast<float>(i % 1000), 1400, 1200}, {1, 2, 0.5f}};
+			system.Submit([&predictor, ball]
+			{
+				std::vector<BallState> path(BallPredictor::DEFAULT_STEPS);
+				predictor.Predict(ball, path);
+				return path.back().position.z;
+			}, [&sum](float z) { sum += z; });
+		}
+		system.WaitIdle();
+		CHECK(system.DrainCompletions() == static_cast<size_t>(jobs));
+		bench::DoNotOptimize(sum);
+		return {bench::Elapsed(start) / 1e9, system.StolenCount()};
+	}
+
+	Result FanOut(unsigned workers, int parents, int children)
+	{
+		JobSystem system(workers);
+		std::atomic<uint64_t> done{0};
+		const auto start = bench::Clock::now();
+		for (int i = 0; i < parents; ++i)
+		{
+			system.Submit([&system, &done, children]
+			{
+				for (int child = 0; child < children; ++child)
+				{
+					system.Submit([&done, child]
+					{
+						uint64_t value = static_cast<uint64_t>(child);
+						for (int round = 0; round < 2000; ++round)
+						{
+							value = value * 6364136223846793005ull + 1442695040888963407ull;
+						}
+						bench::DoNotOptimize(value);
+						done.fetch_add(1, std::memory_order_relaxed);
+					});
+				}
+			});
+		}
+		system.WaitIdle();
+		CHECK(done.load() == static_cast<uint64_t>(parents) * static_cast<uint64_t>(children));
+		return {bench::Elapsed(start) / 1e9, system.StolenCount()};
+	}
+
+	template <typename Fn>
+	void Scale(const char* name, int jobs, Fn&& run)
+	{
+		double single = 0.0;
+		for (unsigned workers : {1u, 2u, 4u, 8u})
+		{
+			const Result result = run(workers);
+			if (workers == 1)
+			{
+				single = result.seconds;
+			}
+			std::printf("%-24s %u worker(s) %10.0f jobs/s  %5.2fx  %8llu stolen\n", name, workers, jobs / result.seconds,
+				single / result.seconds, static_cast<unsigned long long>(result.stolen));
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = bench::Quick(argc, argv);
+	std::printf("%u hardware thread(s)\n", std::thread::hardware_concurrency());
+
+	const int predictions = quick ? 64 : 4096;
+	Scale("predictions", predictions, [&](unsigned workers) { return Predictions(workers, predictions); });
+
+	const int parents = quick ? 8 : 256;
+	const int children = 64;
+	Scale("fan-out", parents * children, [&](unsigned workers) { return FanOut(workers, parents, children); });
+	return 0;
+}
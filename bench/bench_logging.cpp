@@ -0,0 +1,79 @@
+// Cost of a LOG call on the calling thread: formatted and written to the console right there (the flusher isn't
+// running, how LOG worked before StartAsync), and queued for the flusher thread.
+#include "pch.h"
+#include "bench_common.h"
+
+#include <thread>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	// Roughly what the game's console does with a line: keeps the last few hundred
+	struct Console
+	{
+		std::vector<std::string> lines = std::vector<std::string>(512);
+		size_t next = 0;
+
+		void Write(const std::string& text)
+		{
+			lines[next++ % lines.size()] = text;
+		}
+	};
+
+	// Per tick bursts, so the flusher keeps up the way it would in a game
+	constexpr int BURST = 64;
+
+	std::vector<double> Measure(int calls)
+	{
+		std::vector<double> samples;
+		samples.reserve(static_cast<size_t>(calls));
+		const std::string player = "Player 1";
+		for (int i = 0; i < calls; ++i)
+		{
+			const auto start = bench::Clock::now();
+			if (i % 2 == 0)
+			{
+				LOG("ball speed {} at tick {:.2f}", i * 3, static_cast<float>(i) / 120.0f);
+			}
+			else
+			{
+				LOG("{} touched the ball, {} touches", player, i);
+			}
+			samples.push_back(bench::Elapsed(start));
+
+			if (i % BURST == BURST - 1)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+			}
+		}
+		return samples;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int calls = bench::Quick(argc, argv) ? 4'000 : 400'000;
+
+	Console console;
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([&console](const std::string& text) { console.Write(text); });
+
+	std::vector<double> timer;
+	for (int i = 0; i < 10'000; ++i)
+	{
+		const auto start = bench::Clock::now();
+		timer.push_back(bench::Elapsed(start));
+	}
+	bench::PrintLatency("timer overhead", timer);
+
+	auto sync = Measure(calls);
+	bench::PrintLatency("LOG, formatted on the caller", sync);
+
+	logging::StartAsync();
+	auto async = Measure(calls);
+	logging::StopAsync();
+	bench::PrintLatency("LOG, queued for the flusher", async);
+	std::printf("%llu message(s) dropped, %zu lines on the console\n", static_cast<unsigned long long>(logging::DroppedCount()), console.next);
+	return 0;
+}
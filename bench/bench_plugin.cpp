@@ -0,0 +1,317 @@
+// Loads the plugin into the stand-in SDK and plays a synthetic game at tick rate: every tick the listed events are
+// fired through the hooks the plugin registered, the game thread queue runs and the drawables draw. Reports the game
+// thread's CPU time per tick.
+//
+//   bench_plugin [--quick] [--unpaced] [--no-examples] [--ticks N] ["<event>=<calls per tick>" ...]
+//
+// The template's onLoad registers nothing, so unless --no-examples is given the harness also sets up the examples
+// from plugin.cpp's comments (EventBus, HookProfiler, ball prediction, state history, jobs, canvas batch) as the load.
+#include "pch.h"
+#include "BenchPlugin.h"
+#include "bench_common.h"
+#include "standin.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+
+namespace
+{
+	constexpr const char* SET_VEHICLE_INPUT = "Function TAGame.Car_TA.SetVehicleInput";
+	constexpr const char* BALL_TICK = "Function TAGame.Ball_TA.Tick";
+
+	struct StreamEntry
+	{
+		std::string eventName;
+		int calls;
+	};
+
+	// The params of Car_TA.SetVehicleInput
+	struct ControllerInput
+	{
+		float throttle;
+		float steer;
+		float pitch;
+		float yaw;
+		float roll;
+		float dodgeForward;
+		float dodgeStrafe;
+		uint32_t buttons;
+	};
+
+	// What the hooks get as params: the input struct, padded for handlers that read more
+	struct alignas(16) EventParams
+	{
+		ControllerInput input;
+		std::byte padding[224];
+	};
+
+	// Ball flying around a box arena, cars driving in circles
+	class SyntheticGame
+	{
+	public:
+		explicit SyntheticGame(int cars)
+		{
+			state_.cars.resize(static_cast<size_t>(cars));
+			state_.ball.location = {0, 0, 93};
+			state_.ball.velocity = {900, 1400, 1200};
+			state_.ball.angularVelocity = {1, 2, 0.5f};
+		}
+
+		void Step(uint64_t tick)
+		{
+			constexpr float dt = 1.0f / 120.0f;
+			auto& ball = state_.ball;
+			ball.velocity.Z -= 650.0f * dt;
+			ball.location = ball.location + ball.velocity * dt;
+			const float limits[] = {4096, 5120, 2044};
+			float* position[] = {&ball.location.X, &ball.location.Y, &ball.location.Z};
+			float* velocity[] = {&ball.velocity.X, &ball.velocity.Y, &ball.velocity.Z};
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const float low = axis == 2 ? ball.radius : -limits[axis] + ball.radius;
+				const float high = limits[axis] - ball.radius;
+				if (*position[axis] < low || *position[axis] > high)
+				{
+					*position[axis] = (std::clamp)(*position[axis], low, high);
+					*velocity[axis] *= -0.6f;
+				}
+			}
+
+			for (size_t i = 0; i < state_.cars.size(); ++i)
+			{
+				auto& car = state_.cars[i];
+				const float angle = static_cast<float>(tick) * dt + static_cast<float>(i);
+				car.location = {2000 * std::cos(angle), 3000 * std::sin(angle), 17};
+				car.velocity = {-2000 * std::sin(angle), 3000 * std::cos(angle), 0};
+				car.boost.amount = std::fmod(static_cast<float>(tick + i * 100) * 0.001f, 1.0f);
+			}
+
+			params_.input.throttle = 1.0f;
+			params_.input.steer = std::sin(static_cast<float>(tick) * 0.01f);
+		}
+
+		// Car events are called by each car in turn, ball events by the ball, the rest by the game event
+		uintptr_t Caller(const std::string& eventName, int call)
+		{
+			if (eventName.find("Car_TA") != std::string::npos && !state_.cars.empty())
+			{
+				return standin::Address(state_.cars[static_cast<size_t>(call) % state_.cars.size()]);
+			}
+			if (eventName.find("Ball_TA") != std::string::npos)
+			{
+				return standin::Address(state_.ball);
+			}
+			return standin::Address(state_);
+		}
+
+		standin::ServerState& State() { return state_; }
+		EventParams& Params() { return params_; }
+
+	private:
+		standin::ServerState state_;
+		EventParams params_{};
+	};
+
+	// The examples from plugin.cpp's onLoad, wired up against the stand-in
+	class ExampleLoad
+	{
+	public:
+		ExampleLoad(const std::shared_ptr<GameWrapper>& gameWrapper, const std::shared_ptr<CVarManagerWrapper>& cvarManager)
+			: gameWrapper_(gameWrapper), hookProfiler_(gameWrapper), eventBus_(gameWrapper, &hookProfiler_), jobs_(2)
+		{
+			settings_.Bind(&Settings::enabled, cvarManager->registerCvar("bench_enabled", "1", "", true, true, 0, true, 1));
+			settings_.Bind(&Settings::scale, cvarManager->registerCvar("bench_scale", "1.0"));
+
+			eventBus_.Subscribe(SET_VEHICLE_INPUT, [this](ActorWrapper caller, void* params)
+			{
+				const auto* input = static_cast<const ControllerInput*>(params);
+				throttle_ += input->throttle * caller.GetVelocity().X;
+			});
+			eventBus_.Subscribe(BALL_TICK, [this](ActorWrapper caller, void*)
+			{
+				const Vector location = caller.GetLocation(), velocity = caller.GetVelocity(), spin = caller.GetAngularVelocity();
+				const BallState start{{location.X, location.Y, location.Z}, {velocity.X, velocity.Y, velocity.Z}, {spin.X, spin.Y, spin.Z}};
+				predictor_.Predict(start, path_);
+			}, {.coalesce = true});
+
+			hookProfiler_.HookEvent(EventBus::TICK_EVENT, [this](std::string)
+			{
+				if (!settings_.Get().enabled)
+				{
+					return;
+				}
+				history_.Capture(gameWrapper_->GetCurrentGameState());
+				jobs_.DrainCompletions();
+				if (++ticks_ % 30 == 0)
+				{
+					jobs_.Submit([this] { return history_.MaxSpeed(GameStateHistory::BALL, 5 * 120); }, [this](std::optional<float> speed)
+					{
+						maxSpeed_ = speed.value_or(0.0f);
+					});
+				}
+
+				CanvasCommands overlay;
+				overlay.SetColor(255, 200, 0);
+				for (size_t i = 8; i < path_.size(); i += 8)
+				{
+					const auto& from = path_[i - 8].position;
+					const auto& to = path_[i].position;
+					overlay.DrawLine({960 + from.x * 0.1f, 540 + from.y * 0.1f}, {960 + to.x * 0.1f, 540 + to.y * 0.1f});
+				}
+				overlay.DrawString({20, 20}, "max speed");
+				canvasBatch_.Submit(0, std::move(overlay));
+				LOG_THROTTLED(LogLevel::Info, {1.0f, 1.0f}, "ball max speed {:.0f}", maxSpeed_);
+			});
+			gameWrapper->RegisterDrawable([this](CanvasWrapper canvas) { canvasBatch_.Draw(canvas); });
+		}
+
+		~ExampleLoad()
+		{
+			jobs_.WaitIdle();
+			jobs_.DrainCompletions();
+		}
+
+		void PrintStats()
+		{
+			for (const auto& topic : eventBus_.GetStats())
+			{
+				std::printf("  %-60s %10llu dispatched %10llu coalesced\n", topic.eventName.c_str(),
+					static_cast<unsigned long long>(topic.dispatched), static_cast<unsigned long long>(topic.coalesced));
+			}
+		}
+
+	private:
+		struct Settings
+		{
+			bool enabled = false;
+			float scale = 1.0f;
+		};
+
+		std::shared_ptr<GameWrapper> gameWrapper_;
+		HookProfiler hookProfiler_;
+		EventBus eventBus_;
+		JobSystem jobs_;
+		CvarCache<Settings> settings_;
+		BallPredictor predictor_;
+		std::vector<BallState> path_ = std::vector<BallState>(BallPredictor::DEFAULT_STEPS);
+		GameStateHistory history_;
+		CanvasBatch canvasBatch_;
+		float throttle_ = 0.0f;
+		float maxSpeed_ = 0.0f;
+		uint64_t ticks_ = 0;
+	};
+
+	std::vector<StreamEntry> ParseStream(int argc, char** argv, int& ticks)
+	{
+		std::vector<StreamEntry> stream;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			if (arg == "--ticks" && i + 1 < argc)
+			{
+				ticks = std::atoi(argv[++i]);
+			}
+			else if (arg.rfind("--", 0) != 0)
+			{
+				const auto separator = arg.rfind('=');
+				if (separator == std::string::npos)
+				{
+					stream.push_back({arg, 1});
+				}
+				else
+				{
+					stream.push_back({arg.substr(0, separator), std::atoi(arg.c_str() + separator + 1)});
+				}
+			}
+		}
+		if (stream.empty())
+		{
+			// A frame of a 3v3: every car sends its input, the ball ticks, and the viewport ticks once
+			stream = {{EventBus::TICK_EVENT, 1}, {SET_VEHICLE_INPUT, 6}, {BALL_TICK, 1}};
+		}
+		return stream;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = bench::Quick(argc, argv);
+	const bool paced = !bench::HasFlag(argc, argv, "--unpaced");
+	int ticks = quick ? 240 : 120 * 30;
+	const auto stream = ParseStream(argc, argv, ticks);
+
+	auto cvarManager = std::make_shared<CVarManagerWrapper>();
+	auto gameWrapper = std::make_shared<GameWrapper>();
+	size_t logLines = 0;
+	cvarManager->SetLogHandler([&logLines](const std::string&) { ++logLines; });
+
+	SyntheticGame game(6);
+	gameWrapper->SetGameState(&game.State());
+
+	auto plugin = standin::CreatePlugin();
+	plugin->cvarManager = cvarManager;
+	plugin->gameWrapper = gameWrapper;
+	auto loadStart = bench::Clock::now();
+	plugin->onLoad();
+	const double loadNs = bench::Elapsed(loadStart);
+
+	std::unique_ptr<ExampleLoad> examples;
+	if (!bench::HasFlag(argc, argv, "--no-examples"))
+	{
+		examples = std::make_unique<ExampleLoad>(gameWrapper, cvarManager);
+	}
+
+	std::printf("%s %s: %d ticks at 120 Hz%s\n", standin::GetPluginInfo().pluginName, standin::GetPluginInfo().pluginVersion, ticks,
+		paced ? "" : ", unpaced");
+	for (const auto& entry : stream)
+	{
+		std::printf("  %d x %s\n", entry.calls, entry.eventName.c_str());
+	}
+
+	std::vector<double> cpu;
+	std::vector<double> wall;
+	cpu.reserve(static_cast<size_t>(ticks));
+	wall.reserve(static_cast<size_t>(ticks));
+	size_t canvasCalls = 0;
+	const auto period = std::chrono::nanoseconds(1'000'000'000 / 120);
+	auto deadline = bench::Clock::now();
+	for (int tick = 0; tick < ticks; ++tick)
+	{
+		game.Step(static_cast<uint64_t>(tick));
+
+		const double cpuStart = bench::ThreadCpuNs();
+		const auto wallStart = bench::Clock::now();
+		for (const auto& entry : stream)
+		{
+			for (int call = 0; call < entry.calls; ++call)
+			{
+				gameWrapper->FireEvent(entry.eventName, game.Caller(entry.eventName, call), &game.Params());
+			}
+		}
+		gameWrapper->Tick(1.0f / 120.0f);
+		canvasCalls += gameWrapper->Draw();
+		wall.push_back(bench::Elapsed(wallStart));
+		cpu.push_back(bench::ThreadCpuNs() - cpuStart);
+
+		if (paced)
+		{
+			deadline += period;
+			std::this_thread::sleep_until(deadline);
+		}
+	}
+
+	std::printf("onLoad %.3f ms\n", loadNs / 1e6);
+	bench::PrintLatency("per tick, game thread CPU", cpu);
+	bench::PrintLatency("per tick, wall", wall);
+	std::printf("%.1f canvas calls per tick\n", static_cast<double>(canvasCalls) / ticks);
+	if (examples)
+	{
+		examples->PrintStats();
+	}
+
+	examples.reset();
+	plugin->onUnload();
+	std::printf("%zu console lines\n", logLines);
+	return 0;
+}
@@ -0,0 +1,77 @@
+// Throughput of BallPredictor in 6 second trajectories (720 ticks) per second: one path at a time with Predict,
+// and many candidate starts at once with PredictBatch. Checks first that both give the same positions.
+#include "pch.h"
+#include "bench_common.h"
+#include "BallPrediction.h"
+
+#include <cmath>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	// Shots from around the field, so paths hit the floor, walls and ceiling
+	std::vector<BallState> Candidates(size_t count)
+	{
+		std::vector<BallState> starts(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float t = static_cast<float>(i);
+			starts[i].position = {3000 * std::sin(t), 4000 * std::cos(t * 0.7f), 100 + std::fmod(t * 37, 1800.0f)};
+			starts[i].velocity = {2000 * std::cos(t * 1.3f), 2500 * std::sin(t * 0.9f), 1500 * std::sin(t * 2.1f)};
+			starts[i].angularVelocity = {std::sin(t), std::cos(t), 0.5f};
+		}
+		return starts;
+	}
+
+	template <typename Fn>
+	void Run(const char* name, size_t trajectories, int rounds, Fn&& predict)
+	{
+		const auto start = bench::Clock::now();
+		for (int round = 0; round < rounds; ++round)
+		{
+			predict();
+		}
+		const double seconds = bench::Elapsed(start) / 1e9;
+		std::printf("%-28s %10.0f trajectories/s\n", name, static_cast<double>(trajectories) * rounds / seconds);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = bench::Quick(argc, argv);
+	const int rounds = quick ? 2 : 100;
+	constexpr int steps = BallPredictor::DEFAULT_STEPS;
+
+	const BallPredictor predictor;
+	const auto starts = Candidates(256);
+	std::vector<BallState> path(steps);
+	BallPathBatch batch;
+
+	predictor.PredictBatch(starts, steps, batch);
+	for (size_t i = 0; i < starts.size(); ++i)
+	{
+		predictor.Predict(starts[i], path);
+		for (int step = 0; step < steps; step += 30)
+		{
+			const Vec3 expected = path[static_cast<size_t>(step)].position;
+			const Vec3 actual = batch.Position(i, step);
+			CHECK(std::abs(expected.x - actual.x) < 0.5f && std::abs(expected.y - actual.y) < 0.5f && std::abs(expected.z - actual.z) < 0.5f);
+		}
+	}
+
+	Run("Predict, one at a time", starts.size(), rounds, [&]
+	{
+		for (const auto& start : starts)
+		{
+			predictor.Predict(start, path);
+			bench::DoNotOptimize(path.back());
+		}
+	});
+	Run("PredictBatch", starts.size(), rounds, [&]
+	{
+		predictor.PredictBatch(starts, steps, batch);
+		bench::DoNotOptimize(batch.x.back());
+	});
+	return 0;
+}
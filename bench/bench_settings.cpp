@@ -0,0 +1,82 @@
+// SettingsStore with 10k entries: saving them (Set and Flush into a new store, then Close), loading them (Open,
+// which checks every slot, and reading each entry back), and a single Set + Flush on the loaded store.
+#include "pch.h"
+#include "bench_common.h"
+#include "SettingsStore.h"
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	constexpr int ENTRIES = 10'000;
+
+	std::string Key(int i)
+	{
+		return "training.pack." + std::to_string(i);
+	}
+
+	// Mostly small values, every tenth a string too long to stay in its slot
+	bool Set(SettingsStore& store, int i)
+	{
+		const std::string key = Key(i);
+		switch (i % 4)
+		{
+		case 0: return store.SetInt(key, i);
+		case 1: return store.SetFloat(key, i * 0.5);
+		case 2: return store.SetBool(key, i % 3 == 0);
+		default: return store.SetString(key, i % 10 == 3 ? std::string(200, 'a' + i % 26) : "preset " + std::to_string(i));
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int rounds = bench::Quick(argc, argv) ? 2 : 20;
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	const auto dir = std::filesystem::temp_directory_path() / "bakkesmod-bench-settings";
+	const auto path = dir / "settings.bin";
+
+	std::vector<double> save;
+	std::vector<double> load;
+	std::vector<double> single;
+	for (int round = 0; round < rounds; ++round)
+	{
+		std::filesystem::remove_all(dir);
+		SettingsStore store;
+		auto start = bench::Clock::now();
+		CHECK(store.Open(path));
+		for (int i = 0; i < ENTRIES; ++i)
+		{
+			CHECK(Set(store, i));
+		}
+		store.Close();
+		save.push_back(bench::Elapsed(start));
+
+		start = bench::Clock::now();
+		CHECK(store.Open(path));
+		size_t found = 0;
+		for (int i = 0; i < ENTRIES; ++i)
+		{
+			found += store.GetType(Key(i)).has_value();
+			bench::DoNotOptimize(store.GetBytes(Key(i)));
+		}
+		load.push_back(bench::Elapsed(start));
+		CHECK(found == ENTRIES && store.GetInt(Key(400)) == 400);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			start = bench::Clock::now();
+			store.SetInt(Key(i * 4), -i);
+			store.Flush();
+			single.push_back(bench::Elapsed(start));
+		}
+		store.Close();
+	}
+
+	std::printf("%d entries, %.1f MB file\n", ENTRIES, static_cast<double>(std::filesystem::file_size(path)) / 1e6);
+	bench::PrintLatency("save, Set all and Close", save);
+	bench::PrintLatency("load, Open and read all", load);
+	bench::PrintLatency("one Set and Flush", single);
+	std::filesystem::remove_all(dir);
+	return 0;
+}
@@ -0,0 +1,128 @@
+// Telemetry recordings: Append throughput while recording a synthetic session, then the latency of Read seeking to
+// random ticks and the throughput of Stream over the whole file. Checks decoded frames against what was recorded.
+#include "pch.h"
+#include "bench_common.h"
+#include "Telemetry.h"
+
+#include <cmath>
+#include <random>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	// Smooth motion with a teleport now and then (demolitions, kickoffs), which forces keyframes
+	TelemetryFrame MakeFrame(uint64_t tick)
+	{
+		TelemetryFrame frame;
+		const float t = static_cast<float>(tick) / 120.0f;
+		frame.time = t;
+		frame.carCount = 6;
+		frame.pads = tick * 0x9E3779B97F4A7C15ull;
+		const bool teleport = tick % 997 == 0;
+		for (int object = 0; object < GameStateHistory::OBJECTS; ++object)
+		{
+			const float phase = static_cast<float>(object) + (teleport ? 2.0f : 0.0f);
+			float* values = frame.values[object];
+			values[GameStateHistory::X] = 3000 * std::sin(t * 0.5f + phase);
+			values[GameStateHistory::Y] = 4000 * std::cos(t * 0.3f + phase);
+			values[GameStateHistory::Z] = 17 + 500 * std::fabs(std::sin(t + phase));
+			values[GameStateHistory::VX] = 1500 * std::cos(t * 0.5f + phase);
+			values[GameStateHistory::VY] = -1200 * std::sin(t * 0.3f + phase);
+			values[GameStateHistory::VZ] = 500 * std::cos(t + phase);
+			values[GameStateHistory::WX] = std::sin(t * 2 + phase);
+			values[GameStateHistory::WY] = std::cos(t * 2 + phase);
+			values[GameStateHistory::WZ] = 0.5f;
+			values[GameStateHistory::BOOST] = object == GameStateHistory::BALL ? 0.0f : std::fmod(t * 0.05f + phase * 0.1f, 1.0f);
+		}
+		return frame;
+	}
+
+	bool Matches(const TelemetryFrame& decoded, const TelemetryFrame& recorded)
+	{
+		if (decoded.carCount != recorded.carCount || decoded.pads != recorded.pads || std::abs(decoded.time - recorded.time) > 1e-3f)
+		{
+			return false;
+		}
+		for (int object = 0; object < GameStateHistory::OBJECTS; ++object)
+		{
+			for (int channel = 0; channel < GameStateHistory::CHANNELS; ++channel)
+			{
+				// Worst quantization step is 0.1 uu/s
+				if (std::abs(decoded.values[object][channel] - recorded.values[object][channel]) > 0.06f)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = bench::Quick(argc, argv);
+	// Ten minutes of freeplay at 120 Hz
+	const uint64_t frames = quick ? 5'000 : 120 * 600;
+	const auto path = std::filesystem::temp_directory_path() / "bakkesmod-bench-telemetry.bin";
+
+	std::vector<TelemetryFrame> recorded(frames);
+	for (uint64_t tick = 0; tick < frames; ++tick)
+	{
+		recorded[tick] = MakeFrame(tick);
+	}
+
+	TelemetryRecorder recorder;
+	CHECK(recorder.Open(path));
+	std::vector<double> append;
+	append.reserve(frames);
+	const auto recordStart = bench::Clock::now();
+	for (const auto& frame : recorded)
+	{
+		const auto start = bench::Clock::now();
+		recorder.Append(frame);
+		append.push_back(bench::Elapsed(start));
+	}
+	const double recordSeconds = bench::Elapsed(recordStart) / 1e9;
+	recorder.Close();
+	const double megabytes = static_cast<double>(std::filesystem::file_size(path)) / 1e6;
+	std::printf("recorded %llu ticks, %.1f MB, %.0f ticks/s, %.1f MB/s\n", static_cast<unsigned long long>(frames), megabytes,
+		static_cast<double>(frames) / recordSeconds, megabytes / recordSeconds);
+	bench::PrintLatency("Append", append);
+
+	TelemetryReader reader;
+	CHECK(reader.Open(path));
+	CHECK(reader.FrameCount() == frames);
+	std::printf("%zu keyframes in the index\n", reader.Index().size());
+
+	std::mt19937_64 random(42);
+	std::uniform_int_distribution<uint64_t> anyTick(0, frames - 1);
+	std::vector<double> seek;
+	TelemetryFrame frame;
+	const int seeks = quick ? 1'000 : 100'000;
+	for (int i = 0; i < seeks; ++i)
+	{
+		const uint64_t tick = anyTick(random);
+		const auto start = bench::Clock::now();
+		CHECK(reader.Read(tick, frame));
+		seek.push_back(bench::Elapsed(start));
+		CHECK(Matches(frame, recorded[tick]));
+	}
+	bench::PrintLatency("Read, random tick", seek);
+
+	uint64_t streamed = 0;
+	const auto streamStart = bench::Clock::now();
+	CHECK(reader.Stream(0, frames, [&](uint64_t tick, const TelemetryFrame& decoded)
+	{
+		CHECK(tick == streamed++);
+		bench::DoNotOptimize(decoded.values[0][0]);
+	}));
+	const double streamSeconds = bench::Elapsed(streamStart) / 1e9;
+	CHECK(streamed == frames);
+	std::printf("Stream, whole recording %.0f ticks/s\n", static_cast<double>(frames) / streamSeconds);
+	CHECK(reader.Stream(frames / 2, 1, [&](uint64_t, const TelemetryFrame& decoded) { CHECK(Matches(decoded, recorded[frames / 2])); }));
+
+	reader.Close();
+	std::filesystem::remove(path);
+	return 0;
+}
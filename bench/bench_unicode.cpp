@@ -0,0 +1,103 @@
+// Transcoding throughput of unicode.h in MB/s of UTF-8, on ASCII log lines and on mixed-script player names.
+// The ASCII case also runs the byte-by-byte narrowing wide LOG used before (std::string(wide.begin(), wide.end())).
+#include "pch.h"
+#include "bench_common.h"
+#include "unicode.h"
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	struct Corpus
+	{
+		std::vector<std::string> utf8;
+		std::vector<std::wstring> wide;
+		size_t utf8Bytes = 0;
+	};
+
+	Corpus MakeCorpus(const std::vector<std::string>& strings, size_t copies)
+	{
+		Corpus corpus;
+		for (size_t i = 0; i < copies; ++i)
+		{
+			for (const auto& text : strings)
+			{
+				corpus.utf8.push_back(text + std::to_string(i));
+				corpus.wide.push_back(unicode::ToUtf16(corpus.utf8.back()));
+				corpus.utf8Bytes += corpus.utf8.back().size();
+			}
+		}
+		return corpus;
+	}
+
+	template <typename Fn>
+	void Run(const char* name, const Corpus& corpus, int rounds, Fn&& convert)
+	{
+		const auto start = bench::Clock::now();
+		for (int round = 0; round < rounds; ++round)
+		{
+			for (size_t i = 0; i < corpus.wide.size(); ++i)
+			{
+				convert(i);
+			}
+		}
+		const double seconds = bench::Elapsed(start) / 1e9;
+		std::printf("%-44s %8.1f MB/s\n", name, static_cast<double>(corpus.utf8Bytes) * rounds / seconds / 1e6);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int rounds = bench::Quick(argc, argv) ? 5 : 500;
+
+	const Corpus ascii = MakeCorpus({
+		"[HookProfiler] Function TAGame.Car_TA.SetVehicleInput: 1440 calls, p50 0.8 us, p99 3.1 us ",
+		"ball speed 2345 at tick 12.50 ",
+		"Loaded 34 boost pads from C:/Users/player/AppData/Roaming/bakkesmod/bakkesmod/data/pads.json ",
+	}, 300);
+	const Corpus names = MakeCorpus({
+		"xXSniperXx", "Zoë Fjällräven", "Ñandú", "ゲーマー太郎", "Игрок", "플레이어", "\xF0\x9F\x94\xA5" "Blaze" "\xF0\x9F\x94\xA5",
+		"الملك", "Δημήτρης", "李小龙",
+	}, 300);
+
+	std::string narrow;
+	std::wstring wide;
+	for (const Corpus* corpus : {&ascii, &names})
+	{
+		for (size_t i = 0; i < corpus->wide.size(); ++i)
+		{
+			CHECK(unicode::ToUtf8(corpus->wide[i]) == corpus->utf8[i]);
+		}
+	}
+
+	Run("ASCII, wide to UTF-8", ascii, rounds, [&](size_t i)
+	{
+		narrow.clear();
+		unicode::AppendUtf8(ascii.wide[i], narrow);
+		bench::DoNotOptimize(narrow.data());
+	});
+	Run("ASCII, wide to UTF-8, byte by byte (before)", ascii, rounds, [&](size_t i)
+	{
+		narrow = std::string(ascii.wide[i].begin(), ascii.wide[i].end());
+		bench::DoNotOptimize(narrow.data());
+	});
+	Run("ASCII, UTF-8 to wide", ascii, rounds, [&](size_t i)
+	{
+		wide.clear();
+		unicode::AppendUtf16(ascii.utf8[i], wide);
+		bench::DoNotOptimize(wide.data());
+	});
+	Run("player names, wide to UTF-8", names, rounds, [&](size_t i)
+	{
+		narrow.clear();
+		unicode::AppendUtf8(names.wide[i], narrow);
+		bench::DoNotOptimize(narrow.data());
+	});
+	Run("player names, UTF-8 to wide", names, rounds, [&](size_t i)
+	{
+		wide.clear();
+		unicode::AppendUtf16(names.utf8[i], wide);
+		bench::DoNotOptimize(wide.data());
+	});
+	return 0;
+}
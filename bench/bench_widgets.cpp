@@ -0,0 +1,112 @@
+// Frame time of a window with 2k widgets, 200 rows of 10 under PushID like a settings list, with string labels
+// (hashed every frame) and with "label"_id literals (hashed at compile time). Runs ImGui headless: NewFrame to Render,
+// no backend.
+#include "pch.h"
+#include "bench_common.h"
+#include "IMGUI/imgui_literalid.h"
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	constexpr int ROWS = 200;
+
+	struct Row
+	{
+		bool enabled = true;
+		bool visible = false;
+		float scale = 1.0f;
+		float opacity = 0.5f;
+		float size = 12.0f;
+		int preset = 0;
+	};
+
+	void Frame(std::vector<Row>& rows, bool literals)
+	{
+		ImGui::NewFrame();
+		ImGui::SetNextWindowPos(ImVec2(0, 0));
+		ImGui::SetNextWindowSize(ImVec2(1280, 720));
+		ImGui::Begin("Settings");
+		for (int i = 0; i < ROWS; ++i)
+		{
+			Row& row = rows[static_cast<size_t>(i)];
+			ImGui::PushID(i);
+			if (literals)
+			{
+				ImGui::Checkbox("Enabled"_id, &row.enabled);
+				ImGui::Checkbox("Visible##row"_id, &row.visible);
+				ImGui::SliderFloat("Scale"_id, &row.scale, 0.5f, 2.0f);
+				ImGui::SliderFloat("Opacity"_id, &row.opacity, 0.0f, 1.0f);
+				ImGui::SliderFloat("Font size###size"_id, &row.size, 8.0f, 32.0f);
+				ImGui::Button("Reset"_id);
+				ImGui::Button("Remove"_id);
+				ImGui::Button("Move up"_id);
+				ImGui::SearchableCombo("Preset"_id, &row.preset, {"Default", "Minimal"}, "Default", "search");
+				if (ImGui::TreeNode("Details"_id))
+				{
+					ImGui::TreePop();
+				}
+			}
+			else
+			{
+				ImGui::Checkbox("Enabled", &row.enabled);
+				ImGui::Checkbox("Visible##row", &row.visible);
+				ImGui::SliderFloat("Scale", &row.scale, 0.5f, 2.0f);
+				ImGui::SliderFloat("Opacity", &row.opacity, 0.0f, 1.0f);
+				ImGui::SliderFloat("Font size###size", &row.size, 8.0f, 32.0f);
+				ImGui::Button("Reset");
+				ImGui::Button("Remove");
+				ImGui::Button("Move up");
+				ImGui::SearchableCombo("Preset", &row.preset, {"Default", "Minimal"}, "Default", "search");
+				if (ImGui::TreeNode("Details"))
+				{
+					ImGui::TreePop();
+				}
+			}
+			ImGui::PopID();
+		}
+		ImGui::End();
+		ImGui::Render();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int frames = bench::Quick(argc, argv) ? 20 : 2'000;
+
+	ImGui::CreateContext();
+	ImGuiIO& io = ImGui::GetIO();
+	io.IniFilename = nullptr;
+	io.DisplaySize = ImVec2(1920, 1080);
+	io.DeltaTime = 1.0f / 60.0f;
+	unsigned char* pixels = nullptr;
+	int width = 0, height = 0;
+	io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+
+	// Same IDs either way, under the ID stack of a window
+	ImGui::NewFrame();
+	ImGui::Begin("Settings");
+	ImGui::PushID(7);
+	CHECK(ImGui::GetID("Scale") == ImGui::GetID("Scale"_id));
+	CHECK(ImGui::GetID("Font size###size") == ImGui::GetID("Font size###size"_id));
+	ImGui::PopID();
+	ImGui::End();
+	ImGui::EndFrame();
+
+	std::vector<Row> rows(ROWS);
+	std::vector<double> strings;
+	std::vector<double> literals;
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		// Alternating, so both see the same cache and clock conditions
+		const bool literal = frame % 2 == 1;
+		const auto start = bench::Clock::now();
+		Frame(rows, literal);
+		(literal ? literals : strings).push_back(bench::Elapsed(start));
+	}
+	std::printf("%d widgets, %d draw vertices\n", ROWS * 10, ImGui::GetDrawData()->TotalVtxCount);
+	bench::PrintLatency("frame, string labels", strings);
+	bench::PrintLatency("frame, _id literals", literals);
+	ImGui::DestroyContext();
+	return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "IMGUI/imgui.h"
+
+#include <cstddef>
+
+// ImHashData/ImHashStr as ImGui had them before slicing-by-8: one table lookup per byte, "###" resets to the seed
+// wherever it appears. The test checks the current ones against these, the benchmark compares their speed.
+namespace reference
+{
+	struct Crc32Table
+	{
+		ImU32 data[256];
+
+		constexpr Crc32Table() : data()
+		{
+			for (ImU32 i = 0; i < 256; ++i)
+			{
+				ImU32 crc = i;
+				for (int bit = 0; bit < 8; ++bit)
+				{
+					crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+				}
+				data[i] = crc;
+			}
+		}
+	};
+	inline constexpr Crc32Table CRC32_TABLE;
+
+	inline ImU32 HashData(const void* data_p, size_t data_size, ImU32 seed = 0)
+	{
+		ImU32 crc = ~seed;
+		const auto* data = static_cast<const unsigned char*>(data_p);
+		while (data_size-- != 0)
+		{
+			crc = (crc >> 8) ^ CRC32_TABLE.data[(crc & 0xFF) ^ *data++];
+		}
+		return ~crc;
+	}
+
+	inline ImU32 HashStr(const char* data_p, size_t data_size = 0, ImU32 seed = 0)
+	{
+		seed = ~seed;
+		ImU32 crc = seed;
+		const auto* data = reinterpret_cast<const unsigned char*>(data_p);
+		if (data_size != 0)
+		{
+			while (data_size-- != 0)
+			{
+				const unsigned char c = *data++;
+				if (c == '#' && data_size >= 2 && data[0] == '#' && data[1] == '#')
+				{
+					crc = seed;
+				}
+				crc = (crc >> 8) ^ CRC32_TABLE.data[(crc & 0xFF) ^ c];
+			}
+		}
+		else
+		{
+			while (const unsigned char c = *data++)
+			{
+				if (c == '#' && data[0] == '#' && data[1] == '#')
+				{
+					crc = seed;
+				}
+				crc = (crc >> 8) ^ CRC32_TABLE.data[(crc & 0xFF) ^ c];
+			}
+		}
+		return ~crc;
+	}
+}
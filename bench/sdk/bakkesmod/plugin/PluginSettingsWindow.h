@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace BakkesMod::Plugin
+{
+	class PluginSettingsWindow
+	{
+	public:
+		virtual ~PluginSettingsWindow() = default;
+
+		virtual void RenderSettings() = 0;
+		virtual std::string GetPluginName() = 0;
+		virtual void SetImGuiContext(uintptr_t ctx) = 0;
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "../wrappers/cvarmanagerwrapper.h"
+#include "../wrappers/GameWrapper.h"
+
+#include <memory>
+
+enum PLUGINTYPE
+{
+	PLUGINTYPE_FREEPLAY = 0x01,
+	PLUGINTYPE_CUSTOM_TRAINING = 0x02,
+	PLUGINTYPE_SPECTATOR = 0x04,
+	PLUGINTYPE_BOTAI = 0x08,
+	PLUGINTYPE_REPLAY = 0x10,
+	PLUGINTYPE_THREADED = 0x20,
+	PLUGINTYPE_THREADEDUNLOAD = 0x40
+};
+
+namespace BakkesMod::Plugin
+{
+	struct BakkesModPluginInfo
+	{
+		const char* className;
+		const char* pluginName;
+		const char* pluginVersion;
+		int pluginType;
+	};
+
+	class BakkesModPlugin
+	{
+	public:
+		std::shared_ptr<CVarManagerWrapper> cvarManager;
+		std::shared_ptr<GameWrapper> gameWrapper;
+
+		virtual ~BakkesModPlugin() = default;
+		virtual void onLoad() {}
+		virtual void onUnload() {}
+	};
+}
+
+namespace standin
+{
+	// Defined by BAKKESMOD_PLUGIN, the harness links the plugin in instead of loading a DLL
+	const BakkesMod::Plugin::BakkesModPluginInfo& GetPluginInfo();
+	std::unique_ptr<BakkesMod::Plugin::BakkesModPlugin> CreatePlugin();
+}
+
+#define BAKKESMOD_PLUGIN(classType, pluginName, pluginVersion, pluginType) \
+	const BakkesMod::Plugin::BakkesModPluginInfo& standin::GetPluginInfo() \
+	{ \
+		static const BakkesMod::Plugin::BakkesModPluginInfo info{#classType, pluginName, pluginVersion, pluginType}; \
+		return info; \
+	} \
+	std::unique_ptr<BakkesMod::Plugin::BakkesModPlugin> standin::CreatePlugin() \
+	{ \
+		return std::make_unique<classType>(); \
+	}
@@ -0,0 +1,19 @@
+#pragma once
+#include "ObjectWrapper.h"
+#include "../wrapperstructs.h"
+
+class ActorWrapper : public ObjectWrapper
+{
+public:
+	explicit ActorWrapper(uintptr_t mem) : ObjectWrapper(mem) {}
+
+	Vector GetLocation();
+	void SetLocation(Vector location);
+	Vector GetVelocity();
+	void SetVelocity(Vector velocity);
+	Vector GetAngularVelocity();
+	Rotator GetRotation();
+
+	bool IsNull() const { return memory_address == 0; }
+	explicit operator bool() const { return !IsNull(); }
+};
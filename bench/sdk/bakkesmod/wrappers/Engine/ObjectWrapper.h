@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// Wrappers hold the address of the object they wrap. In the stand-in SDK that is a state struct from standin.h.
+class ObjectWrapper
+{
+public:
+	explicit ObjectWrapper(uintptr_t mem) : memory_address(mem) {}
+
+	uintptr_t memory_address;
+};
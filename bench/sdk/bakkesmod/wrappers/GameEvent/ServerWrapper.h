@@ -0,0 +1,16 @@
+#pragma once
+#include "../Engine/ActorWrapper.h"
+#include "../GameObject/BallWrapper.h"
+#include "../GameObject/CarWrapper.h"
+#include "../arraywrapper.h"
+
+class ServerWrapper : public ActorWrapper
+{
+public:
+	explicit ServerWrapper(uintptr_t mem) : ActorWrapper(mem) {}
+
+	BallWrapper GetBall();
+	ArrayWrapper<CarWrapper> GetCars();
+};
+
+extern template class ArrayWrapper<CarWrapper>;
@@ -0,0 +1,10 @@
+#pragma once
+#include "../Engine/ActorWrapper.h"
+
+class BallWrapper : public ActorWrapper
+{
+public:
+	explicit BallWrapper(uintptr_t mem) : ActorWrapper(mem) {}
+
+	float GetRadius();
+};
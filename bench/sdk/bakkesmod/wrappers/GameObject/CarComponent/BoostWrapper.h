@@ -0,0 +1,14 @@
+#pragma once
+#include "../../Engine/ObjectWrapper.h"
+
+class BoostWrapper : public ObjectWrapper
+{
+public:
+	explicit BoostWrapper(uintptr_t mem) : ObjectWrapper(mem) {}
+
+	float GetCurrentBoostAmount();
+	void SetCurrentBoostAmount(float amount);
+
+	bool IsNull() const { return memory_address == 0; }
+	explicit operator bool() const { return !IsNull(); }
+};
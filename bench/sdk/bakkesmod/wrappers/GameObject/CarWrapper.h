@@ -0,0 +1,11 @@
+#pragma once
+#include "../Engine/ActorWrapper.h"
+#include "CarComponent/BoostWrapper.h"
+
+class CarWrapper : public ActorWrapper
+{
+public:
+	explicit CarWrapper(uintptr_t mem) : ActorWrapper(mem) {}
+
+	BoostWrapper GetBoostComponent();
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include "canvaswrapper.h"
+#include "Engine/ActorWrapper.h"
+#include "GameEvent/ServerWrapper.h"
+#include "GameObject/BallWrapper.h"
+#include "GameObject/CarWrapper.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace standin
+{
+	struct ServerState;
+}
+
+// Hooks, the game thread queue and drawables run synchronously when the harness calls FireEvent/Tick/Draw,
+// on the harness's thread, which stands in for the game thread.
+class GameWrapper
+{
+public:
+	GameWrapper();
+	~GameWrapper();
+
+	GameWrapper(const GameWrapper&) = delete;
+	GameWrapper& operator=(const GameWrapper&) = delete;
+
+	void HookEvent(std::string eventName, std::function<void(std::string eventName)> callback);
+	void HookEventPost(std::string eventName, std::function<void(std::string eventName)> callback);
+	void UnhookEvent(std::string eventName);
+	void UnhookEventPost(std::string eventName);
+
+	template <typename T> requires std::is_base_of_v<ObjectWrapper, T>
+	void HookEventWithCaller(std::string eventName, std::function<void(T caller, void* params, std::string eventName)> callback)
+	{
+		AddHook(std::move(eventName), false, [callback = std::move(callback)](uintptr_t caller, void* params, const std::string& name)
+		{
+			callback(T(caller), params, name);
+		});
+	}
+
+	template <typename T> requires std::is_base_of_v<ObjectWrapper, T>
+	void HookEventWithCallerPost(std::string eventName, std::function<void(T caller, void* params, std::string eventName)> callback)
+	{
+		AddHook(std::move(eventName), true, [callback = std::move(callback)](uintptr_t caller, void* params, const std::string& name)
+		{
+			callback(T(caller), params, name);
+		});
+	}
+
+	// Runs on the game thread on the next Tick
+	void Execute(std::function<void(GameWrapper*)> theLambda);
+	void SetTimeout(std::function<void(GameWrapper*)> theLambda, float time);
+
+	void RegisterDrawable(std::function<void(CanvasWrapper)> callback);
+	void UnregisterDrawables();
+
+	std::filesystem::path GetDataFolder();
+	std::filesystem::path GetBakkesModPath();
+
+	ServerWrapper GetCurrentGameState();
+	ServerWrapper GetGameEventAsServer();
+	bool IsInGame();
+	bool IsInOnlineGame();
+	bool IsInFreeplay();
+
+	// Stand-in only, the harness plays the game with these.
+	// Calls the pre hooks of the event, then its post hooks. `caller` is the address of a state struct from standin.h.
+	void FireEvent(const std::string& eventName, uintptr_t caller = 0, void* params = nullptr);
+	// Advances the game clock and runs what Execute and SetTimeout queued
+	void Tick(float seconds);
+	// Calls the drawables with a canvas that records nothing, returns how many canvas calls they made
+	size_t Draw();
+	// The game the wrappers read, nullptr for the main menu. Owned by the harness.
+	void SetGameState(standin::ServerState* state);
+	// Defaults to a folder under the system's temp directory
+	void SetDataFolder(std::filesystem::path folder);
+
+private:
+	using Hook = std::function<void(uintptr_t caller, void* params, const std::string& eventName)>;
+
+	void AddHook(std::string eventName, bool post, Hook hook);
+
+	struct Impl;
+	std::unique_ptr<Impl> impl_;
+};
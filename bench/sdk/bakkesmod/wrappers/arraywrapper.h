@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+template <typename T>
+class ArrayWrapper
+{
+public:
+	explicit ArrayWrapper(uintptr_t mem) : memory_address(mem) {}
+
+	int Count();
+	T Get(int index);
+	bool IsNull() const { return memory_address == 0; }
+
+	uintptr_t memory_address;
+};
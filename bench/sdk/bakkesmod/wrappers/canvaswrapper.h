@@ -0,0 +1,27 @@
+#pragma once
+#include "Engine/ObjectWrapper.h"
+#include "wrapperstructs.h"
+
+#include <string>
+
+class CanvasWrapper : public ObjectWrapper
+{
+public:
+	explicit CanvasWrapper(uintptr_t mem) : ObjectWrapper(mem) {}
+
+	void SetPosition(Vector2 pos);
+	void SetPosition(Vector2F pos);
+	Vector2F GetPositionFloat();
+	void SetColor(char red, char green, char blue, char alpha);
+	void SetColor(LinearColor color);
+	void DrawBox(Vector2 size);
+	void DrawBox(Vector2F size);
+	void FillBox(Vector2 size);
+	void FillBox(Vector2F size);
+	void DrawLine(Vector2 start, Vector2 end);
+	void DrawLine(Vector2F start, Vector2F end, float width);
+	void DrawString(std::string text);
+	void DrawString(std::string text, float xScale, float yScale, bool dropShadow = false, bool wrap = false);
+	Vector2F GetStringSize(std::string text, float xScale = 1.0f, float yScale = 1.0f);
+	Vector2 GetSize();
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "cvarwrapper.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum NOTIFIER_PERMISSION
+{
+	PERMISSION_ALL = 0,
+	PERMISSION_MENU = 1 << 0,
+	PERMISSION_SOCCAR = 1 << 1,
+	PERMISSION_FREEPLAY = 1 << 2,
+	PERMISSION_CUSTOM_TRAINING = 1 << 3,
+	PERMISSION_ONLINE = 1 << 4,
+	PERMISSION_PAUSEMENU_CLOSED = 1 << 5,
+	PERMISSION_REPLAY = 1 << 6,
+	PERMISSION_OFFLINE = 1 << 7
+};
+
+class CVarManagerWrapper
+{
+public:
+	CVarManagerWrapper();
+	~CVarManagerWrapper();
+
+	CVarManagerWrapper(const CVarManagerWrapper&) = delete;
+	CVarManagerWrapper& operator=(const CVarManagerWrapper&) = delete;
+
+	// "name args; name args", arguments may be quoted. A notifier gets the name as args[0], a cvar with an argument is set.
+	void executeCommand(std::string command, bool log = true);
+	void registerNotifier(std::string cvar, std::function<void(std::vector<std::string>)> notifier, std::string description, unsigned char permissions);
+	bool removeNotifier(std::string cvar);
+	// Registering a name that exists returns the existing cvar
+	CVarWrapper registerCvar(std::string cvar, std::string defaultValue, std::string desc = "", bool searchAble = true, bool hasMin = false,
+		float min = 0, bool hasMax = false, float max = 0, bool saveToCfg = true);
+	bool removeCvar(std::string cvar);
+	// A null CVarWrapper if there is no such cvar
+	CVarWrapper getCvar(std::string cvar);
+
+	// Any thread
+	void log(std::string text);
+	void log(std::wstring text);
+
+	// Stand-in only: where log() output goes, stdout by default. Called under a lock.
+	void SetLogHandler(std::function<void(const std::string&)> handler);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> impl_;
+};
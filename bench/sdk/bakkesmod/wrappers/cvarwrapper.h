@@ -0,0 +1,38 @@
+#pragma once
+#include "Engine/ObjectWrapper.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+class CVarWrapper : public ObjectWrapper
+{
+public:
+	explicit CVarWrapper(uintptr_t mem) : ObjectWrapper(mem) {}
+
+	std::string getCVarName();
+	std::string getDescription();
+	std::string getStringValue();
+	int getIntValue();
+	float getFloatValue();
+	bool getBoolValue();
+
+	// Values outside the cvar's range are clamped
+	void setValue(std::string value);
+	void setValue(int value);
+	void setValue(float value);
+	void ResetToDefault();
+
+	// Called after the value changed, with the value it had before
+	void addOnValueChanged(std::function<void(std::string oldValue, CVarWrapper cvar)> callback);
+	void removeOnValueChanged();
+
+	// The variable follows the cvar's value
+	void bindTo(std::shared_ptr<int> var);
+	void bindTo(std::shared_ptr<float> var);
+	void bindTo(std::shared_ptr<std::string> var);
+	void bindTo(std::shared_ptr<bool> var);
+
+	bool IsNull() const { return memory_address == 0; }
+	explicit operator bool() const { return !IsNull(); }
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+struct Vector
+{
+	float X, Y, Z;
+
+	Vector(float x, float y, float z) : X(x), Y(y), Z(z) {}
+	Vector(float def) : X(def), Y(def), Z(def) {}
+	Vector() : X(0), Y(0), Z(0) {}
+
+	Vector operator+(const Vector& other) const { return {X + other.X, Y + other.Y, Z + other.Z}; }
+	Vector operator-(const Vector& other) const { return {X - other.X, Y - other.Y, Z - other.Z}; }
+	Vector operator*(float scale) const { return {X * scale, Y * scale, Z * scale}; }
+};
+
+struct Rotator
+{
+	int Pitch, Yaw, Roll;
+
+	Rotator(int pitch, int yaw, int roll) : Pitch(pitch), Yaw(yaw), Roll(roll) {}
+	Rotator() : Pitch(0), Yaw(0), Roll(0) {}
+};
+
+struct Vector2
+{
+	int X;
+	int Y;
+};
+
+struct Vector2F
+{
+	float X;
+	float Y;
+};
+
+struct LinearColor
+{
+	float R, G, B, A;
+};
@@ -0,0 +1,778 @@
+#include "standin.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace
+{
+	struct CvarState
+	{
+		std::string name;
+		std::string description;
+		std::string defaultValue;
+		std::string value;
+		bool hasMin = false;
+		bool hasMax = false;
+		float min = 0;
+		float max = 0;
+		std::vector<std::function<void(std::string, CVarWrapper)>> callbacks;
+		std::vector<std::variant<std::shared_ptr<int>, std::shared_ptr<float>, std::shared_ptr<std::string>, std::shared_ptr<bool>>> bindings;
+	};
+
+	CvarState& Cvar(uintptr_t address)
+	{
+		return *reinterpret_cast<CvarState*>(address);
+	}
+
+	float ToFloat(const std::string& value)
+	{
+		return std::strtof(value.c_str(), nullptr);
+	}
+
+	std::string FormatFloat(float value)
+	{
+		char text[32];
+		std::snprintf(text, sizeof(text), "%g", value);
+		return text;
+	}
+
+	void AppendUtf8(std::string& out, char32_t c)
+	{
+		if (c < 0x80)
+		{
+			out += static_cast<char>(c);
+		}
+		else if (c < 0x800)
+		{
+			out += static_cast<char>(0xC0 | (c >> 6));
+			out += static_cast<char>(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			out += static_cast<char>(0xE0 | (c >> 12));
+			out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			out += static_cast<char>(0xF0 | (c >> 18));
+			out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+			out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (c & 0x3F));
+		}
+	}
+
+	// wchar_t is UTF-16 on Windows and UTF-32 here, handles both
+	std::string ToUtf8(const std::wstring& text)
+	{
+		std::string out;
+		out.reserve(text.size());
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			char32_t c = static_cast<char32_t>(text[i]);
+			if (c >= 0xD800 && c < 0xDC00 && i + 1 < text.size())
+			{
+				const auto low = static_cast<char32_t>(text[i + 1]);
+				if (low >= 0xDC00 && low < 0xE000)
+				{
+					c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+					++i;
+				}
+			}
+			AppendUtf8(out, c);
+		}
+		return out;
+	}
+
+	// Splits "a b; c \"d e\"" into commands and their quoted arguments
+	std::vector<std::vector<std::string>> ParseCommands(const std::string& text)
+	{
+		std::vector<std::vector<std::string>> commands(1);
+		std::string token;
+		bool inToken = false;
+		bool quoted = false;
+		const auto endToken = [&]
+		{
+			if (inToken)
+			{
+				commands.back().push_back(std::move(token));
+				token.clear();
+				inToken = false;
+			}
+		};
+		for (const char c : text)
+		{
+			if (c == '"')
+			{
+				quoted = !quoted;
+				inToken = true;
+			}
+			else if (quoted)
+			{
+				token += c;
+			}
+			else if (c == ';')
+			{
+				endToken();
+				commands.emplace_back();
+			}
+			else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+			{
+				endToken();
+			}
+			else
+			{
+				token += c;
+				inToken = true;
+			}
+		}
+		endToken();
+		std::erase_if(commands, [](const auto& command) { return command.empty(); });
+		return commands;
+	}
+
+	struct CanvasState
+	{
+		size_t calls = 0;
+		Vector2F position{};
+	};
+
+	CanvasState& Canvas(uintptr_t address)
+	{
+		return *reinterpret_cast<CanvasState*>(address);
+	}
+
+	standin::ActorState* Actor(uintptr_t address)
+	{
+		return reinterpret_cast<standin::ActorState*>(address);
+	}
+
+	template <typename T>
+	struct StateOf;
+
+	template <>
+	struct StateOf<CarWrapper>
+	{
+		using Type = standin::CarState;
+	};
+}
+
+// CVarWrapper
+
+std::string CVarWrapper::getCVarName()
+{
+	return Cvar(memory_address).name;
+}
+
+std::string CVarWrapper::getDescription()
+{
+	return Cvar(memory_address).description;
+}
+
+std::string CVarWrapper::getStringValue()
+{
+	return Cvar(memory_address).value;
+}
+
+int CVarWrapper::getIntValue()
+{
+	return static_cast<int>(getFloatValue());
+}
+
+float CVarWrapper::getFloatValue()
+{
+	return ToFloat(Cvar(memory_address).value);
+}
+
+bool CVarWrapper::getBoolValue()
+{
+	return getFloatValue() != 0.0f;
+}
+
+void CVarWrapper::setValue(std::string value)
+{
+	CvarState& cvar = Cvar(memory_address);
+	if (cvar.hasMin || cvar.hasMax)
+	{
+		char* end = nullptr;
+		const float number = std::strtof(value.c_str(), &end);
+		if (end != value.c_str())
+		{
+			float clamped = number;
+			if (cvar.hasMin)
+			{
+				clamped = (std::max)(clamped, cvar.min);
+			}
+			if (cvar.hasMax)
+			{
+				clamped = (std::min)(clamped, cvar.max);
+			}
+			if (clamped != number)
+			{
+				value = FormatFloat(clamped);
+			}
+		}
+	}
+
+	std::string oldValue = std::exchange(cvar.value, std::move(value));
+	for (const auto& binding : cvar.bindings)
+	{
+		std::visit([this](const auto& variable)
+		{
+			using T = typename std::decay_t<decltype(variable)>::element_type;
+			if constexpr (std::is_same_v<T, int>)
+			{
+				*variable = getIntValue();
+			}
+			else if constexpr (std::is_same_v<T, float>)
+			{
+				*variable = getFloatValue();
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				*variable = getBoolValue();
+			}
+			else
+			{
+				*variable = getStringValue();
+			}
+		}, binding);
+	}
+
+	// Callbacks may register more callbacks
+	const auto callbacks = cvar.callbacks;
+	for (const auto& callback : callbacks)
+	{
+		callback(oldValue, *this);
+	}
+}
+
+void CVarWrapper::setValue(int value)
+{
+	setValue(std::to_string(value));
+}
+
+void CVarWrapper::setValue(float value)
+{
+	setValue(std::to_string(value));
+}
+
+void CVarWrapper::ResetToDefault()
+{
+	setValue(Cvar(memory_address).defaultValue);
+}
+
+void CVarWrapper::addOnValueChanged(std::function<void(std::string, CVarWrapper)> callback)
+{
+	Cvar(memory_address).callbacks.push_back(std::move(callback));
+}
+
+void CVarWrapper::removeOnValueChanged()
+{
+	Cvar(memory_address).callbacks.clear();
+}
+
+void CVarWrapper::bindTo(std::shared_ptr<int> var)
+{
+	*var = getIntValue();
+	Cvar(memory_address).bindings.emplace_back(std::move(var));
+}
+
+void CVarWrapper::bindTo(std::shared_ptr<float> var)
+{
+	*var = getFloatValue();
+	Cvar(memory_address).bindings.emplace_back(std::move(var));
+}
+
+void CVarWrapper::bindTo(std::shared_ptr<std::string> var)
+{
+	*var = getStringValue();
+	Cvar(memory_address).bindings.emplace_back(std::move(var));
+}
+
+void CVarWrapper::bindTo(std::shared_ptr<bool> var)
+{
+	*var = getBoolValue();
+	Cvar(memory_address).bindings.emplace_back(std::move(var));
+}
+
+// CVarManagerWrapper
+
+struct CVarManagerWrapper::Impl
+{
+	struct Notifier
+	{
+		std::function<void(std::vector<std::string>)> callback;
+		std::string description;
+		unsigned char permissions;
+	};
+
+	std::unordered_map<std::string, std::unique_ptr<CvarState>> cvars;
+	// CVarWrappers of removed cvars may still be around
+	std::vector<std::unique_ptr<CvarState>> removed;
+	std::unordered_map<std::string, Notifier> notifiers;
+
+	std::mutex logMutex;
+	std::function<void(const std::string&)> logHandler = [](const std::string& text) { std::cout << text << '\n'; };
+};
+
+CVarManagerWrapper::CVarManagerWrapper() : impl_(std::make_unique<Impl>())
+{
+}
+
+CVarManagerWrapper::~CVarManagerWrapper() = default;
+
+void CVarManagerWrapper::executeCommand(std::string command, bool log)
+{
+	for (auto& args : ParseCommands(command))
+	{
+		if (const auto notifier = impl_->notifiers.find(args[0]); notifier != impl_->notifiers.end())
+		{
+			// The notifier may remove itself
+			const auto callback = notifier->second.callback;
+			callback(std::move(args));
+		}
+		else if (CVarWrapper cvar = getCvar(args[0]))
+		{
+			if (args.size() > 1)
+			{
+				cvar.setValue(args[1]);
+			}
+			else if (log)
+			{
+				this->log(args[0] + " = " + cvar.getStringValue());
+			}
+		}
+		else if (log)
+		{
+			this->log("Unknown command: " + args[0]);
+		}
+	}
+}
+
+void CVarManagerWrapper::registerNotifier(std::string cvar, std::function<void(std::vector<std::string>)> notifier, std::string description, unsigned char permissions)
+{
+	impl_->notifiers[std::move(cvar)] = {std::move(notifier), std::move(description), permissions};
+}
+
+bool CVarManagerWrapper::removeNotifier(std::string cvar)
+{
+	return impl_->notifiers.erase(cvar) != 0;
+}
+
+CVarWrapper CVarManagerWrapper::registerCvar(std::string cvar, std::string defaultValue, std::string desc, bool searchAble, bool hasMin,
+	float min, bool hasMax, float max, bool saveToCfg)
+{
+	auto& state = impl_->cvars[cvar];
+	if (!state)
+	{
+		state = std::make_unique<CvarState>();
+		state->name = std::move(cvar);
+		state->description = std::move(desc);
+		state->defaultValue = defaultValue;
+		state->value = std::move(defaultValue);
+		state->hasMin = hasMin;
+		state->min = min;
+		state->hasMax = hasMax;
+		state->max = max;
+	}
+	return CVarWrapper(reinterpret_cast<uintptr_t>(state.get()));
+}
+
+bool CVarManagerWrapper::removeCvar(std::string cvar)
+{
+	const auto state = impl_->cvars.find(cvar);
+	if (state == impl_->cvars.end())
+	{
+		return false;
+	}
+	impl_->removed.push_back(std::move(state->second));
+	impl_->cvars.erase(state);
+	return true;
+}
+
+CVarWrapper CVarManagerWrapper::getCvar(std::string cvar)
+{
+	const auto state = impl_->cvars.find(cvar);
+	return CVarWrapper(state == impl_->cvars.end() ? 0 : reinterpret_cast<uintptr_t>(state->second.get()));
+}
+
+void CVarManagerWrapper::log(std::string text)
+{
+	std::lock_guard lock(impl_->logMutex);
+	if (impl_->logHandler)
+	{
+		impl_->logHandler(text);
+	}
+}
+
+void CVarManagerWrapper::log(std::wstring text)
+{
+	log(ToUtf8(text));
+}
+
+void CVarManagerWrapper::SetLogHandler(std::function<void(const std::string&)> handler)
+{
+	std::lock_guard lock(impl_->logMutex);
+	impl_->logHandler = std::move(handler);
+}
+
+// Game objects
+
+Vector ActorWrapper::GetLocation()
+{
+	return memory_address ? Actor(memory_address)->location : Vector();
+}
+
+void ActorWrapper::SetLocation(Vector location)
+{
+	if (memory_address)
+	{
+		Actor(memory_address)->location = location;
+	}
+}
+
+Vector ActorWrapper::GetVelocity()
+{
+	return memory_address ? Actor(memory_address)->velocity : Vector();
+}
+
+void ActorWrapper::SetVelocity(Vector velocity)
+{
+	if (memory_address)
+	{
+		Actor(memory_address)->velocity = velocity;
+	}
+}
+
+Vector ActorWrapper::GetAngularVelocity()
+{
+	return memory_address ? Actor(memory_address)->angularVelocity : Vector();
+}
+
+Rotator ActorWrapper::GetRotation()
+{
+	return memory_address ? Actor(memory_address)->rotation : Rotator();
+}
+
+float BallWrapper::GetRadius()
+{
+	return memory_address ? reinterpret_cast<standin::BallState*>(memory_address)->radius : 0.0f;
+}
+
+float BoostWrapper::GetCurrentBoostAmount()
+{
+	return memory_address ? reinterpret_cast<standin::BoostState*>(memory_address)->amount : 0.0f;
+}
+
+void BoostWrapper::SetCurrentBoostAmount(float amount)
+{
+	if (memory_address)
+	{
+		reinterpret_cast<standin::BoostState*>(memory_address)->amount = amount;
+	}
+}
+
+BoostWrapper CarWrapper::GetBoostComponent()
+{
+	auto* car = reinterpret_cast<standin::CarState*>(memory_address);
+	return BoostWrapper(car && car->hasBoost ? standin::Address(car->boost) : 0);
+}
+
+BallWrapper ServerWrapper::GetBall()
+{
+	auto* server = reinterpret_cast<standin::ServerState*>(memory_address);
+	return BallWrapper(server && server->hasBall ? standin::Address(server->ball) : 0);
+}
+
+ArrayWrapper<CarWrapper> ServerWrapper::GetCars()
+{
+	auto* server = reinterpret_cast<standin::ServerState*>(memory_address);
+	return ArrayWrapper<CarWrapper>(server ? standin::Address(server->cars) : 0);
+}
+
+// Points at a std::vector of the element's state struct
+template <typename T>
+int ArrayWrapper<T>::Count()
+{
+	using Elements = std::vector<typename StateOf<T>::Type>;
+	return memory_address ? static_cast<int>(reinterpret_cast<Elements*>(memory_address)->size()) : 0;
+}
+
+template <typename T>
+T ArrayWrapper<T>::Get(int index)
+{
+	using Elements = std::vector<typename StateOf<T>::Type>;
+	auto* elements = reinterpret_cast<Elements*>(memory_address);
+	if (!elements || index < 0 || static_cast<size_t>(index) >= elements->size())
+	{
+		return T(0);
+	}
+	return T(standin::Address((*elements)[static_cast<size_t>(index)]));
+}
+
+template class ArrayWrapper<CarWrapper>;
+
+// CanvasWrapper
+
+void CanvasWrapper::SetPosition(Vector2 pos)
+{
+	SetPosition(Vector2F{static_cast<float>(pos.X), static_cast<float>(pos.Y)});
+}
+
+void CanvasWrapper::SetPosition(Vector2F pos)
+{
+	Canvas(memory_address).position = pos;
+	++Canvas(memory_address).calls;
+}
+
+Vector2F CanvasWrapper::GetPositionFloat()
+{
+	return Canvas(memory_address).position;
+}
+
+void CanvasWrapper::SetColor(char, char, char, char)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::SetColor(LinearColor)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::DrawBox(Vector2)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::DrawBox(Vector2F)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::FillBox(Vector2)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::FillBox(Vector2F)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::DrawLine(Vector2, Vector2)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::DrawLine(Vector2F, Vector2F, float)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::DrawString(std::string)
+{
+	++Canvas(memory_address).calls;
+}
+
+void CanvasWrapper::DrawString(std::string, float, float, bool, bool)
+{
+	++Canvas(memory_address).calls;
+}
+
+Vector2F CanvasWrapper::GetStringSize(std::string text, float xScale, float yScale)
+{
+	// The console font's cell
+	return {static_cast<float>(text.size()) * 8.0f * xScale, 12.0f * yScale};
+}
+
+Vector2 CanvasWrapper::GetSize()
+{
+	return {1920, 1080};
+}
+
+// GameWrapper
+
+struct GameWrapper::Impl
+{
+	struct Timeout
+	{
+		float due;
+		std::function<void(GameWrapper*)> callback;
+	};
+
+	// Copied on write, so hooks can be added while an event is being dispatched
+	using Hooks = std::shared_ptr<const std::vector<Hook>>;
+	std::unordered_map<std::string, Hooks> pre;
+	std::unordered_map<std::string, Hooks> post;
+
+	std::vector<std::function<void(GameWrapper*)>> queue;
+	std::vector<Timeout> timeouts;
+	std::vector<std::function<void(CanvasWrapper)>> drawables;
+	float time = 0.0f;
+
+	standin::ServerState* state = nullptr;
+	std::filesystem::path bakkesModPath = std::filesystem::temp_directory_path() / "bakkesmod-standin";
+	std::filesystem::path dataFolder = bakkesModPath / "data";
+};
+
+GameWrapper::GameWrapper() : impl_(std::make_unique<Impl>())
+{
+}
+
+GameWrapper::~GameWrapper() = default;
+
+void GameWrapper::HookEvent(std::string eventName, std::function<void(std::string)> callback)
+{
+	AddHook(std::move(eventName), false, [callback = std::move(callback)](uintptr_t, void*, const std::string& name) { callback(name); });
+}
+
+void GameWrapper::HookEventPost(std::string eventName, std::function<void(std::string)> callback)
+{
+	AddHook(std::move(eventName), true, [callback = std::move(callback)](uintptr_t, void*, const std::string& name) { callback(name); });
+}
+
+void GameWrapper::UnhookEvent(std::string eventName)
+{
+	impl_->pre.erase(eventName);
+}
+
+void GameWrapper::UnhookEventPost(std::string eventName)
+{
+	impl_->post.erase(eventName);
+}
+
+void GameWrapper::AddHook(std::string eventName, bool post, Hook hook)
+{
+	auto& hooks = (post ? impl_->post : impl_->pre)[std::move(eventName)];
+	auto updated = hooks ? std::make_shared<std::vector<Hook>>(*hooks) : std::make_shared<std::vector<Hook>>();
+	updated->push_back(std::move(hook));
+	hooks = std::move(updated);
+}
+
+void GameWrapper::Execute(std::function<void(GameWrapper*)> theLambda)
+{
+	impl_->queue.push_back(std::move(theLambda));
+}
+
+void GameWrapper::SetTimeout(std::function<void(GameWrapper*)> theLambda, float time)
+{
+	impl_->timeouts.push_back({impl_->time + time, std::move(theLambda)});
+}
+
+void GameWrapper::RegisterDrawable(std::function<void(CanvasWrapper)> callback)
+{
+	impl_->drawables.push_back(std::move(callback));
+}
+
+void GameWrapper::UnregisterDrawables()
+{
+	impl_->drawables.clear();
+}
+
+std::filesystem::path GameWrapper::GetDataFolder()
+{
+	return impl_->dataFolder;
+}
+
+std::filesystem::path GameWrapper::GetBakkesModPath()
+{
+	return impl_->bakkesModPath;
+}
+
+ServerWrapper GameWrapper::GetCurrentGameState()
+{
+	return ServerWrapper(impl_->state ? standin::Address(*impl_->state) : 0);
+}
+
+ServerWrapper GameWrapper::GetGameEventAsServer()
+{
+	return GetCurrentGameState();
+}
+
+bool GameWrapper::IsInGame()
+{
+	return impl_->state != nullptr;
+}
+
+bool GameWrapper::IsInOnlineGame()
+{
+	return false;
+}
+
+bool GameWrapper::IsInFreeplay()
+{
+	return impl_->state != nullptr;
+}
+
+void GameWrapper::FireEvent(const std::string& eventName, uintptr_t caller, void* params)
+{
+	for (auto* table : {&impl_->pre, &impl_->post})
+	{
+		const auto found = table->find(eventName);
+		if (found == table->end())
+		{
+			continue;
+		}
+		// Keeps the list alive if a hook unhooks the event
+		const Impl::Hooks hooks = found->second;
+		for (const Hook& hook : *hooks)
+		{
+			hook(caller, params, eventName);
+		}
+	}
+}
+
+void GameWrapper::Tick(float seconds)
+{
+	impl_->time += seconds;
+
+	auto queue = std::move(impl_->queue);
+	impl_->queue.clear();
+	for (auto& callback : queue)
+	{
+		callback(this);
+	}
+
+	std::vector<Impl::Timeout> due;
+	std::erase_if(impl_->timeouts, [&](Impl::Timeout& timeout)
+	{
+		if (timeout.due > impl_->time)
+		{
+			return false;
+		}
+		due.push_back(std::move(timeout));
+		return true;
+	});
+	for (auto& timeout : due)
+	{
+		timeout.callback(this);
+	}
+}
+
+size_t GameWrapper::Draw()
+{
+	CanvasState canvas;
+	for (const auto& drawable : impl_->drawables)
+	{
+		drawable(CanvasWrapper(reinterpret_cast<uintptr_t>(&canvas)));
+	}
+	return canvas.calls;
+}
+
+void GameWrapper::SetGameState(standin::ServerState* state)
+{
+	impl_->state = state;
+}
+
+void GameWrapper::SetDataFolder(std::filesystem::path folder)
+{
+	impl_->dataFolder = std::move(folder);
+}
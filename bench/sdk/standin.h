@@ -0,0 +1,47 @@
+#pragma once
+#include "bakkesmod/plugin/bakkesmodplugin.h"
+
+#include <vector>
+
+// A Linux stand-in for the parts of the BakkesMod SDK the template uses, for building benchmarks and tests
+// without the game. Header compatible with the real SDK: plugin code compiles against it unchanged.
+// The wrappers point at the plain structs below, which the harness owns and fills in.
+namespace standin
+{
+	struct ActorState
+	{
+		Vector location;
+		Vector velocity;
+		Vector angularVelocity;
+		Rotator rotation;
+	};
+
+	struct BallState : ActorState
+	{
+		float radius = 91.25f;
+	};
+
+	struct BoostState
+	{
+		float amount = 0.33f;
+	};
+
+	struct CarState : ActorState
+	{
+		BoostState boost;
+		bool hasBoost = true;
+	};
+
+	struct ServerState
+	{
+		BallState ball;
+		bool hasBall = true;
+		std::vector<CarState> cars;
+	};
+
+	template <typename T>
+	uintptr_t Address(T& state)
+	{
+		return reinterpret_cast<uintptr_t>(&state);
+	}
+}
@@ -0,0 +1,49 @@
+// A destroyed EventBus leaves no hooks behind, and a handler that throws doesn't leave its topic stuck mid-dispatch.
+#include "pch.h"
+#include "bench_common.h"
+#include "EventBus.h"
+
+#include <stdexcept>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+int main()
+{
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	auto gameWrapper = std::make_shared<GameWrapper>();
+	int calls = 0;
+
+	{
+		EventBus bus(gameWrapper);
+		bus.Subscribe("Function A", [&calls](ActorWrapper, void*) { ++calls; });
+		bus.Subscribe("Function B", [&calls](ActorWrapper, void*) { ++calls; }, {.post = true});
+		gameWrapper->FireEvent("Function A");
+		gameWrapper->FireEvent("Function B");
+		CHECK(calls == 2);
+	}
+	gameWrapper->FireEvent("Function A");
+	gameWrapper->FireEvent("Function B");
+	CHECK(calls == 2);
+
+	EventBus bus(gameWrapper);
+	const auto throwing = bus.Subscribe("Function C", [](ActorWrapper, void*) { throw std::runtime_error("handler failed"); });
+	bus.Subscribe("Function C", [&calls](ActorWrapper, void*) { ++calls; });
+	bool thrown = false;
+	try
+	{
+		gameWrapper->FireEvent("Function C");
+	}
+	catch (const std::runtime_error&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	// Outside a dispatch the subscriber is removed right away
+	bus.Unsubscribe(throwing);
+	const auto stats = bus.GetStats();
+	CHECK(stats.size() == 1 && stats[0].subscribers == 1);
+	gameWrapper->FireEvent("Function C");
+	CHECK(calls == 3);
+	return 0;
+}
@@ -0,0 +1,53 @@
+// GameStateHistory tick numbers keep counting across Clear(), so reads at ticks from before it fail.
+#include "pch.h"
+#include "bench_common.h"
+#include "GameStateHistory.h"
+#include "standin.h"
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+int main()
+{
+	standin::ServerState state;
+	state.cars.resize(2);
+	GameWrapper gameWrapper;
+	gameWrapper.SetGameState(&state);
+
+	GameStateHistory history(64);
+	auto capture = [&](float x)
+	{
+		state.ball.location.X = x;
+		history.Capture(gameWrapper.GetCurrentGameState());
+	};
+
+	for (int i = 0; i < 10; ++i)
+	{
+		capture(static_cast<float>(i));
+	}
+	CHECK(history.Begin() == 0 && history.End() == 10);
+	const uint64_t cursor = history.End() - 1;
+	float x = 0.0f;
+	CHECK(history.Copy(GameStateHistory::BALL, GameStateHistory::X, cursor, {&x, 1}) && x == 9.0f);
+
+	history.Clear();
+	CHECK(history.End() == 10 && history.Begin() == 10);
+	CHECK(!history.Copy(GameStateHistory::BALL, GameStateHistory::X, cursor, {&x, 1}));
+	CHECK(!history.MaxSpeed(GameStateHistory::BALL, 1));
+
+	// The first tick after Clear() doesn't reuse the kept cursor's number
+	capture(100.0f);
+	CHECK(history.End() == 11 && history.Begin() == 10);
+	CHECK(!history.Copy(GameStateHistory::BALL, GameStateHistory::X, cursor, {&x, 1}));
+	CHECK(history.Copy(GameStateHistory::BALL, GameStateHistory::X, 10, {&x, 1}) && x == 100.0f);
+	float two[2];
+	CHECK(!history.Copy(GameStateHistory::BALL, GameStateHistory::X, 9, two));
+
+	// Wrapping the ring still works from the new base
+	for (int i = 0; i < 100; ++i)
+	{
+		capture(static_cast<float>(200 + i));
+	}
+	CHECK(history.End() == 111 && history.Begin() == 111 - 63);
+	CHECK(history.Copy(GameStateHistory::BALL, GameStateHistory::X, 110, {&x, 1}) && x == 299.0f);
+	return 0;
+}
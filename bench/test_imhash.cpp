@@ -0,0 +1,60 @@
+// ImHashStr and ImHashData give the same IDs as the byte-at-a-time CRC32 they replaced, over random strings with
+// unaligned starts and runs of '#', real-looking labels, and random seeds.
+#include "pch.h"
+#include "bench_common.h"
+#include "imhash_reference.h"
+#include "IMGUI/imgui_internal.h"
+
+#include <random>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+int main()
+{
+	std::mt19937 random(12345);
+	std::uniform_int_distribution<int> length(0, 300);
+	std::uniform_int_distribution<int> offset(0, 15);
+	std::uniform_int_distribution<int> anyByte(1, 255);
+	std::uniform_int_distribution<int> percent(0, 99);
+
+	const std::vector<std::string> labels = {
+		"Save", "Enable plugin", "Scale##overlay", "Color###color_picker", "##hidden", "###", "####", "a###b###c",
+		"Training pack ##3", "Ball prediction/Steps", "", "#", "##", "# ## ###",
+	};
+
+	size_t hashes = 0;
+	std::string buffer;
+	for (int i = 0; i < 300'000; ++i)
+	{
+		const int start = offset(random);
+		std::string text;
+		if (i < static_cast<int>(labels.size()))
+		{
+			text = labels[static_cast<size_t>(i)];
+		}
+		else
+		{
+			text.resize(static_cast<size_t>(length(random)));
+			// Every other string is mostly '#', so resets land at every position
+			const bool dense = i % 2 == 0;
+			for (char& c : text)
+			{
+				c = dense && percent(random) < 60 ? '#' : static_cast<char>(anyByte(random));
+			}
+		}
+		// Unaligned starts, zero terminated
+		buffer.assign(static_cast<size_t>(start), 'x');
+		buffer += text;
+		const char* data = buffer.c_str() + start;
+
+		for (const ImU32 seed : {ImU32{0}, static_cast<ImU32>(random())})
+		{
+			CHECK(ImHashStr(data, 0, seed) == reference::HashStr(data, 0, seed));
+			CHECK(ImHashStr(data, text.size(), seed) == reference::HashStr(data, text.size(), seed));
+			CHECK(ImHashData(data, text.size(), seed) == reference::HashData(data, text.size(), seed));
+			hashes += 3;
+		}
+	}
+	std::printf("%zu hashes identical\n", hashes);
+	return 0;
+}
@@ -0,0 +1,37 @@
+// Jobs that throw are logged as failed without taking the worker or WaitIdle down with them.
+#include "pch.h"
+#include "bench_common.h"
+#include "JobSystem.h"
+
+#include <stdexcept>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+int main()
+{
+	std::vector<std::string> console;
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([&console](const std::string& text) { console.push_back(text); });
+
+	JobSystem jobs(1);
+	std::atomic<int> ran{0};
+	int completed = 0;
+	jobs.Submit([] { throw std::runtime_error("bad input"); });
+	jobs.Submit([] { throw 42; });
+	jobs.Submit([]() -> int { throw std::runtime_error("no result"); }, [&completed](int) { ++completed; });
+	jobs.Submit([&ran] { return ++ran; }, [&completed](int) { ++completed; });
+	jobs.Submit([&ran] { ++ran; });
+	jobs.WaitIdle();
+	jobs.DrainCompletions();
+
+	auto count = [&console](std::string_view text)
+	{
+		return std::count_if(console.begin(), console.end(), [text](const std::string& line) { return line.find(text) != std::string::npos; });
+	};
+	CHECK(ran == 2);
+	CHECK(completed == 1);
+	CHECK(count("job failed: bad input") == 1);
+	CHECK(count("job failed with an unknown exception") == 1);
+	CHECK(count("job failed: no result") == 1);
+	return 0;
+}
@@ -0,0 +1,84 @@
+// Format errors on the flusher and on the caller, format strings that aren't literals, and messages logged
+// while StopAsync runs.
+#include "pch.h"
+#include "bench_common.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	constexpr char PADDED[16] = "padded {}";
+	static_assert(FormatString("static {}").isStatic);
+	static_assert(FormatString(PADDED).str == "padded {}");
+}
+
+int main()
+{
+	std::vector<std::string> console;
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([&console](const std::string& text) { console.push_back(text); });
+
+	logging::StartAsync();
+
+	// Formatted on the flusher, with the format string copied into the record
+	std::string mismatched = "{} and {}";
+	LOG(std::string_view(mismatched), 1);
+
+	// Not deferrable, formatted on the caller into its slot
+	LOG(std::string_view(mismatched), std::chrono::seconds(1));
+
+	char buffer[32];
+	std::strcpy(buffer, "from a buffer {}");
+	LOG(std::string_view(buffer), 2);
+	std::strcpy(buffer, "overwritten {}!!");
+
+	LOG("literal {}", 3);
+	LOG(PADDED, 4);
+	logging::StopAsync();
+
+	CHECK(console.size() == 5);
+	CHECK(console[0].starts_with("{} and {} [format error: "));
+	CHECK(console[1].starts_with("{} and {} [format error: "));
+	CHECK(console[2] == "from a buffer 2");
+	CHECK(console[3] == "literal 3");
+	CHECK(console[4] == "padded 4");
+
+	// Each message comes out exactly once, from the final drain or, once the backend is stopped, straight to the console.
+	// 4 x 500 records fit in the ring, so none are dropped.
+	int lines = 0;
+	_globalCvarManager->SetLogHandler([&lines](const std::string&) { ++lines; });
+	for (int round = 0; round < 20; ++round)
+	{
+		lines = 0;
+		logging::StartAsync();
+		std::atomic<bool> go{false};
+		std::vector<std::thread> producers;
+		for (int thread = 0; thread < 4; ++thread)
+		{
+			producers.emplace_back([&go]
+			{
+				while (!go.load())
+				{
+					std::this_thread::yield();
+				}
+				for (int i = 0; i < 500; ++i)
+				{
+					LOG("racing {}", i);
+				}
+			});
+		}
+		go = true;
+		logging::StopAsync();
+		for (auto& producer : producers)
+		{
+			producer.join();
+		}
+		CHECK(lines == 4 * 500);
+	}
+	CHECK(logging::DroppedCount() == 0);
+	return 0;
+}
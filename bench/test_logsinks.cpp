@@ -0,0 +1,77 @@
+// MappedFileSink keeps the previous session's log, and a file left behind by a crash holds only the log.
+#include "pch.h"
+#include "bench_common.h"
+#include "LogSinks.h"
+
+#include <fstream>
+#include <iterator>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	std::string ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	}
+
+	size_t CountLines(const std::string& text)
+	{
+		return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+	}
+}
+
+int main()
+{
+	const auto dir = std::filesystem::temp_directory_path() / "bakkesmod-test-logsinks";
+	std::filesystem::remove_all(dir);
+	const auto path = dir / "plugin.log";
+	const auto previous = dir / "plugin.1.log";
+
+	// Closed normally: cut to what was written
+	{
+		MappedFileSink sink(path, 64 * 1024);
+		sink.Write(LogLevel::Info, "first session");
+	}
+	auto text = ReadFile(path);
+	CHECK(text.starts_with(MappedFileSink::HEADER_PREFIX));
+	CHECK(text.ends_with("[info] first session\n"));
+	CHECK(CountLines(text) == 2);
+
+	// Crashed: never closed, one line written after the last flush. The mapping stays around like the page cache would.
+	auto* crashed = new MappedFileSink(path, 64 * 1024);
+	CHECK(std::filesystem::file_size(previous) == text.size());
+	crashed->Write(LogLevel::Info, "flushed");
+	crashed->Flush();
+	crashed->Write(LogLevel::Warn, "not flushed");
+	CHECK(std::filesystem::file_size(path) == 64 * 1024);
+
+	{
+		MappedFileSink sink(path, 64 * 1024);
+		text = ReadFile(previous);
+		CHECK(text.find('\0') == std::string::npos);
+		CHECK(text.find("[info] flushed\n") != std::string::npos);
+		CHECK(text.ends_with("[warn] not flushed\n"));
+		CHECK(ReadFile(dir / "plugin.2.log").ends_with("first session\n"));
+	}
+
+	// Full files rotate, the oldest one is dropped
+	{
+		MappedFileSink sink(path, 1024, 3);
+		for (int i = 0; i < 100; ++i)
+		{
+			sink.Write(LogLevel::Debug, "a line long enough to fill a kilobyte in a few dozen writes");
+		}
+	}
+	CHECK(!std::filesystem::exists(dir / "plugin.3.log"));
+	for (const auto& file : {path, previous, dir / "plugin.2.log"})
+	{
+		text = ReadFile(file);
+		CHECK(text.size() <= 1024);
+		CHECK(text.find('\0') == std::string::npos);
+	}
+
+	std::filesystem::remove_all(dir);
+	return 0;
+}
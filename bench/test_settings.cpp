@@ -0,0 +1,108 @@
+// SettingsStore rejects damaged files on Open, and Rebuild replaces the file only once the new one is complete.
+#include "pch.h"
+#include "bench_common.h"
+#include "SettingsStore.h"
+
+#include <fstream>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+namespace
+{
+	// Offsets in the file, see SettingsStore::Header and SettingsStore::Slot
+	constexpr size_t PAGE = 4096;
+	constexpr size_t HEADER_USED = 24;
+	constexpr size_t SLOT_SIZE = 128;
+	constexpr size_t SLOT_STATE = 8;
+	constexpr size_t SLOT_VALUE_LENGTH = 12;
+	constexpr size_t SLOT_VALUE = 64;
+
+	template <typename T>
+	T ReadAt(const std::filesystem::path& path, size_t offset)
+	{
+		T value{};
+		std::ifstream file(path, std::ios::binary);
+		file.seekg(static_cast<std::streamoff>(offset));
+		file.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return value;
+	}
+
+	template <typename T>
+	void WriteAt(const std::filesystem::path& path, size_t offset, const T& value)
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(static_cast<std::streamoff>(offset));
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	// The first slot whose value lives in the heap
+	size_t HeapSlot(const std::filesystem::path& path)
+	{
+		for (size_t offset = PAGE;; offset += SLOT_SIZE)
+		{
+			if (ReadAt<uint8_t>(path, offset + SLOT_STATE) == 1 && ReadAt<uint32_t>(path, offset + SLOT_VALUE_LENGTH) > SettingsStore::INLINE_VALUE)
+			{
+				return offset;
+			}
+		}
+	}
+}
+
+int main()
+{
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([](const std::string&) {});
+
+	const auto dir = std::filesystem::temp_directory_path() / "bakkesmod-test-settings";
+	std::filesystem::remove_all(dir);
+	const auto path = dir / "settings.bin";
+	const std::string longValue(300, 'x');
+
+	SettingsStore store;
+	CHECK(store.Open(path));
+	CHECK(store.SetInt("count", 42));
+	CHECK(store.SetString("bindings", longValue));
+	store.Close();
+
+	// A used count that doesn't match the slots
+	const auto used = ReadAt<uint64_t>(path, HEADER_USED);
+	WriteAt(path, HEADER_USED, used + 1);
+	CHECK(!store.Open(path));
+	WriteAt(path, HEADER_USED, used);
+
+	// A heap offset past the end of the file
+	const size_t slot = HeapSlot(path);
+	const auto offset = ReadAt<uint64_t>(path, slot + SLOT_VALUE);
+	WriteAt(path, slot + SLOT_VALUE, uint64_t{1} << 40);
+	CHECK(!store.Open(path));
+	WriteAt(path, slot + SLOT_VALUE, offset);
+
+	// A Rebuild the game didn't get to finish leaves its temporary file, the store is still the old one
+	std::ofstream(dir / "settings.bin.tmp") << "partial";
+	CHECK(store.Open(path));
+	CHECK(!std::filesystem::exists(dir / "settings.bin.tmp"));
+	CHECK(store.GetInt("count") == 42 && store.GetString("bindings") == longValue);
+
+	// Growing past the initial table rebuilds it, erased entries and replaced heap values are dropped
+	store.Erase("count");
+	for (int i = 0; i < 2000; ++i)
+	{
+		CHECK(store.SetString("key" + std::to_string(i), i % 10 == 0 ? longValue + std::to_string(i) : std::to_string(i)));
+	}
+	CHECK(store.SetString("bindings", longValue + "!"));
+	CHECK(!std::filesystem::exists(dir / "settings.bin.tmp"));
+	store.Close();
+
+	CHECK(store.Open(path));
+	CHECK(store.Size() == 2001);
+	CHECK(!store.GetInt("count"));
+	CHECK(store.GetString("bindings") == longValue + "!");
+	for (int i = 0; i < 2000; ++i)
+	{
+		CHECK(store.GetString("key" + std::to_string(i)) == (i % 10 == 0 ? longValue + std::to_string(i) : std::to_string(i)));
+	}
+	store.Close();
+
+	std::filesystem::remove_all(dir);
+	return 0;
+}
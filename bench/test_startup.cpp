@@ -0,0 +1,50 @@
+// Startup tasks that throw, std::exception or not, are logged as failed and don't take the worker down.
+#include "pch.h"
+#include "bench_common.h"
+#include "StartupPhases.h"
+
+#include <stdexcept>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+int main()
+{
+	std::vector<std::string> console;
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([&console](const std::string& text) { console.push_back(text); });
+
+	JobSystem jobs(1);
+	bool doneRan = false;
+	{
+		StartupPhases startup(jobs);
+		const auto& loaded = startup.Async("loads", [](std::stop_token) {}, [&doneRan] { doneRan = true; });
+		const auto& standard = startup.Async("throws runtime_error", [](std::stop_token) { throw std::runtime_error("bad file"); });
+		const auto& unknown = startup.Async("throws int", [](std::stop_token) { throw 42; });
+		startup.Finish();
+		jobs.WaitIdle();
+		jobs.DrainCompletions();
+
+		CHECK(startup.AllFinished());
+		CHECK(!startup.AllSucceeded());
+		CHECK(loaded && !standard && !unknown);
+		CHECK(doneRan);
+	}
+
+	// Only tasks that succeed
+	{
+		StartupPhases startup(jobs);
+		startup.Async("loads", [](std::stop_token) {});
+		CHECK(!startup.AllFinished() && !startup.AllSucceeded());
+		startup.Finish();
+		jobs.WaitIdle();
+		CHECK(startup.AllFinished() && startup.AllSucceeded());
+	}
+
+	auto contains = [&console](std::string_view text)
+	{
+		return std::any_of(console.begin(), console.end(), [text](const std::string& line) { return line.find(text) != std::string::npos; });
+	};
+	CHECK(contains("startup task throws runtime_error failed: bad file"));
+	CHECK(contains("startup task throws int failed with an unknown exception"));
+	return 0;
+}
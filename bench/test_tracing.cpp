@@ -0,0 +1,49 @@
+// Trace event names are copied: strings and profilers that are gone before the export still show up by name.
+#include "pch.h"
+#include "bench_common.h"
+#include "HookProfiler.h"
+
+#include <fstream>
+#include <iterator>
+
+std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+int main()
+{
+	_globalCvarManager = std::make_shared<CVarManagerWrapper>();
+	_globalCvarManager->SetLogHandler([](const std::string&) {});
+	const auto path = std::filesystem::temp_directory_path() / "bakkesmod-test-trace.json";
+
+	tracing::Start();
+	{
+		std::string threadName = "main thread";
+		tracing::SetThreadName(threadName.c_str());
+		threadName = "overwritten";
+	}
+	{
+		char name[32] = "zone from a buffer";
+		tracing::Complete(name, "test", tracing::Clock::now(), tracing::Clock::now());
+		// Same pointer, different string
+		std::strcpy(name, "second zone");
+		tracing::Complete(name, "test", tracing::Clock::now(), tracing::Clock::now());
+		std::strcpy(name, "clobbered");
+	}
+	{
+		auto gameWrapper = std::make_shared<GameWrapper>();
+		HookProfiler profiler(gameWrapper);
+		profiler.HookEvent("Function TAGame.Ball_TA.Explode", [](std::string) {});
+		gameWrapper->FireEvent("Function TAGame.Ball_TA.Explode");
+	}
+	tracing::Stop();
+	CHECK(tracing::Export(path));
+
+	std::ifstream file(path);
+	const std::string json{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	CHECK(json.find("\"main thread\"") != std::string::npos);
+	CHECK(json.find("\"zone from a buffer\"") != std::string::npos);
+	CHECK(json.find("\"second zone\"") != std::string::npos);
+	CHECK(json.find("\"Function TAGame.Ball_TA.Explode\"") != std::string::npos);
+	CHECK(json.find("overwritten") == std::string::npos && json.find("clobbered") == std::string::npos);
+	std::filesystem::remove(path);
+	return 0;
+}
@@ -0,0 +1,534 @@
+#include "pch.h"
+#include "logging.h"
+#include "tracing.h"
+
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace logging::detail
+{
+	LogQueue queue;
+	std::atomic<bool> asyncEnabled = false;
+	std::atomic<uint32_t> activeProducers = 0;
+	std::atomic<LogLevel> minLevel = DEBUG_LOG ? LogLevel::Debug : LogLevel::Info;
+
+	namespace
+	{
+		constexpr size_t CALL_SITE_CAPACITY = 1024; // power of two
+
+		struct CallSite
+		{
+			std::atomic<uint64_t> key{0};
+			std::atomic<uint64_t> calls{0};
+			// GCRA form of the token bucket: the time the bucket is back to full, in steady_clock ticks
+			std::atomic<int64_t> theoreticalArrival{0};
+			std::atomic<std::string*> location{nullptr};
+
+			~CallSite()
+			{
+				delete location.load(std::memory_order_relaxed);
+			}
+		};
+
+		CallSite callSites[CALL_SITE_CAPACITY];
+
+		uint64_t CallSiteKey(const std::source_location& loc)
+		{
+			// The file and function names are literals, their addresses identify the site together with the line
+			uint64_t h = reinterpret_cast<uintptr_t>(loc.file_name()) ^ (reinterpret_cast<uintptr_t>(loc.function_name()) << 1);
+			h ^= (static_cast<uint64_t>(loc.line()) << 32) | loc.column();
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			return h == 0 ? 1 : h;
+		}
+
+		CallSite* FindCallSite(const std::source_location& loc)
+		{
+			const uint64_t key = CallSiteKey(loc);
+			for (size_t i = 0; i < CALL_SITE_CAPACITY; ++i)
+			{
+				CallSite& site = callSites[(key + i) & (CALL_SITE_CAPACITY - 1)];
+				uint64_t existing = site.key.load(std::memory_order_acquire);
+				if (existing == key)
+				{
+					return &site;
+				}
+				if (existing == 0 && site.key.compare_exchange_strong(existing, key, std::memory_order_acq_rel))
+				{
+					return &site;
+				}
+				// Lost the race for an empty entry, maybe to the same call site on another thread
+				if (existing == key)
+				{
+					return &site;
+				}
+			}
+			return nullptr;
+		}
+
+		std::thread flusher;
+		std::atomic<bool> stopRequested = false;
+
+		class ConsoleSink final : public LogSink
+		{
+		public:
+			void Write(LogLevel, std::string_view text) override
+			{
+				_globalCvarManager->log(std::string(text));
+			}
+		};
+
+		std::shared_ptr<LogSink> consoleSink = std::make_shared<ConsoleSink>();
+		bool consoleSinkRemoved = false;
+
+		std::mutex sinksMutex;
+		std::vector<std::shared_ptr<LogSink>> sinks;
+		std::atomic<uint32_t> sinksVersion = 0;
+
+		// The flusher's copy of the sink list, refreshed when sinksVersion changes
+		std::vector<std::shared_ptr<LogSink>> activeSinks;
+		uint32_t activeSinksVersion = ~0u;
+
+		void RefreshSinks()
+		{
+			const uint32_t version = sinksVersion.load(std::memory_order_acquire);
+			if (version != activeSinksVersion)
+			{
+				std::lock_guard lock(sinksMutex);
+				activeSinks = sinks;
+				activeSinksVersion = version;
+			}
+		}
+
+		void WriteToSinks(LogLevel level, std::string_view text)
+		{
+			for (const auto& sink : activeSinks)
+			{
+				if (level >= sink->minLevel.load(std::memory_order_relaxed))
+				{
+					sink->Write(level, text);
+				}
+			}
+		}
+
+		void FlushSinks()
+		{
+			for (const auto& sink : activeSinks)
+			{
+				sink->Flush();
+			}
+		}
+
+		constexpr auto FLUSH_IDLE_SLEEP = std::chrono::milliseconds(2);
+
+		// Output iterator for std::vformat_to that stops writing at the end of the slot.
+		struct BoundedWriter
+		{
+			using difference_type = std::ptrdiff_t;
+
+			char* cur;
+			char* end;
+
+			BoundedWriter& operator=(char c)
+			{
+				if (cur != end)
+				{
+					*cur++ = c;
+				}
+				return *this;
+			}
+
+			BoundedWriter& operator*() { return *this; }
+			BoundedWriter& operator++() { return *this; }
+			BoundedWriter operator++(int) { return *this; }
+		};
+
+		void ReportDropped(uint64_t& reported)
+		{
+			const auto dropped = queue.dropped.load(std::memory_order_relaxed);
+			if (dropped != reported)
+			{
+				WriteToSinks(LogLevel::Warn, std::format("[logging] ring full, dropped {} message(s)", dropped - reported));
+				reported = dropped;
+			}
+		}
+
+		// This is the only place records get formatted
+		std::string DecodeRecord(const LogSlot& slot, LogLevel& level)
+		{
+			RecordHeader header;
+			std::memcpy(&header, slot.payload, sizeof(header));
+			level = header.level;
+			const std::byte* cur = slot.payload + sizeof(header);
+			const std::byte* end = slot.payload + slot.size;
+
+			std::string text;
+			if (header.decode)
+			{
+				std::string_view format;
+				if (header.format)
+				{
+					format = {header.format, header.formatSize};
+				}
+				else
+				{
+					format = {reinterpret_cast<const char*>(cur), header.formatSize};
+					cur += header.formatSize;
+				}
+				try
+				{
+					header.decode(format, cur, text);
+				}
+				catch (const std::format_error& error)
+				{
+					text.clear();
+					AppendFormatError(text, format, error);
+				}
+			}
+			else
+			{
+				text.assign(reinterpret_cast<const char*>(cur), end - cur);
+			}
+
+			if (header.withLocation)
+			{
+				text += ' ';
+				text += InternLocation(header.location);
+			}
+			return text;
+		}
+
+		void WriteRecord(const LogSlot& slot)
+		{
+			LogLevel level;
+			const std::string text = DecodeRecord(slot, level);
+			WriteToSinks(level, text);
+		}
+
+		void Drain()
+		{
+			while (LogSlot* slot = queue.Peek())
+			{
+				WriteRecord(*slot);
+				queue.Release(slot);
+			}
+		}
+
+		void FlusherMain()
+		{
+			tracing::SetThreadName("log flusher");
+			uint64_t reportedDrops = queue.dropped.load(std::memory_order_relaxed);
+			bool idle = true;
+			tracing::Clock::time_point batchStart;
+			int64_t batchRecords = 0;
+			while (!stopRequested.load(std::memory_order_acquire))
+			{
+				RefreshSinks();
+				if (LogSlot* slot = queue.Peek())
+				{
+					if (idle)
+					{
+						batchStart = tracing::Clock::now();
+						batchRecords = 0;
+					}
+					WriteRecord(*slot);
+					queue.Release(slot);
+					++batchRecords;
+					idle = false;
+					continue;
+				}
+				ReportDropped(reportedDrops);
+				if (!idle)
+				{
+					FlushSinks();
+					tracing::Complete("log flush", "log", batchStart, tracing::Clock::now(), "records", batchRecords);
+					idle = true;
+				}
+				std::this_thread::sleep_for(FLUSH_IDLE_SLEEP);
+			}
+			RefreshSinks();
+			Drain();
+			ReportDropped(reportedDrops);
+			FlushSinks();
+			activeSinks.clear();
+			activeSinksVersion = ~0u;
+		}
+	}
+
+	LogQueue::LogQueue()
+	{
+		for (size_t i = 0; i < QUEUE_CAPACITY; ++i)
+		{
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	LogSlot* LogQueue::Claim()
+	{
+		size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			LogSlot& slot = slots_[pos & (QUEUE_CAPACITY - 1)];
+			const size_t seq = slot.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+			if (diff == 0)
+			{
+				if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					return &slot;
+				}
+			}
+			else if (diff < 0)
+			{
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			else
+			{
+				pos = enqueuePos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void LogQueue::Publish(LogSlot* slot)
+	{
+		// A claimed slot's sequence equals its claim position, the consumer waits for position + 1
+		slot->sequence.store(slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	LogSlot* LogQueue::Peek()
+	{
+		LogSlot& slot = slots_[dequeuePos_ & (QUEUE_CAPACITY - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1)
+		{
+			return nullptr;
+		}
+		return &slot;
+	}
+
+	void LogQueue::Release(LogSlot* slot)
+	{
+		slot->sequence.store(dequeuePos_ + QUEUE_CAPACITY, std::memory_order_release);
+		++dequeuePos_;
+	}
+
+	std::string_view InternLocation(const std::source_location& loc)
+	{
+		CallSite* site = FindCallSite(loc);
+		if (!site)
+		{
+			thread_local std::string overflow;
+			overflow = std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line());
+			return overflow;
+		}
+
+		if (const std::string* location = site->location.load(std::memory_order_acquire))
+		{
+			return *location;
+		}
+
+		auto* built = new std::string(std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line()));
+		std::string* expected = nullptr;
+		if (!site->location.compare_exchange_strong(expected, built, std::memory_order_acq_rel))
+		{
+			// Another thread interned it first
+			delete built;
+			return *expected;
+		}
+		return *built;
+	}
+
+	bool AcquireRateLimit(const std::source_location& loc, RateLimit limit)
+	{
+		CallSite* site = FindCallSite(loc);
+		if (!site)
+		{
+			return true;
+		}
+		if (limit.perSecond <= 0.0f)
+		{
+			return false;
+		}
+
+		using Clock = std::chrono::steady_clock;
+		const auto interval = static_cast<int64_t>(static_cast<double>(Clock::period::den) / Clock::period::num / limit.perSecond);
+		const auto tolerance = static_cast<int64_t>(interval * (std::max)(limit.burst - 1.0f, 0.0f));
+		const int64_t now = Clock::now().time_since_epoch().count();
+
+		int64_t tat = site->theoreticalArrival.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			if (now < tat - tolerance)
+			{
+				return false;
+			}
+			const int64_t next = (std::max)(tat, now) + interval;
+			if (site->theoreticalArrival.compare_exchange_weak(tat, next, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+	}
+
+	bool AcquireSample(const std::source_location& loc, uint32_t everyN)
+	{
+		CallSite* site = FindCallSite(loc);
+		if (!site || everyN <= 1)
+		{
+			return true;
+		}
+		return site->calls.fetch_add(1, std::memory_order_relaxed) % everyN == 0;
+	}
+
+	void PushText(LogLevel level, const std::source_location& loc, bool withLocation, std::string_view text)
+	{
+		LogSlot* slot = queue.Claim();
+		if (!slot)
+		{
+			return;
+		}
+
+		const RecordHeader header{nullptr, nullptr, 0, level, withLocation, loc};
+		std::memcpy(slot->payload, &header, sizeof(header));
+		const size_t size = (std::min)(text.size(), MAX_RECORD_SIZE - sizeof(header));
+		std::memcpy(slot->payload + sizeof(header), text.data(), size);
+		slot->size = static_cast<uint32_t>(sizeof(header) + size);
+		LogQueue::Publish(slot);
+	}
+
+	void PushFormatted(LogLevel level, const FormatString& format_str, bool withLocation, std::format_args args)
+	{
+		LogSlot* slot = queue.Claim();
+		if (!slot)
+		{
+			return;
+		}
+
+		const RecordHeader header{nullptr, nullptr, 0, level, withLocation, format_str.loc};
+		std::memcpy(slot->payload, &header, sizeof(header));
+
+		auto* text = reinterpret_cast<char*>(slot->payload + sizeof(header));
+		BoundedWriter out{text, text + (MAX_RECORD_SIZE - sizeof(header))};
+		try
+		{
+			out = std::vformat_to(out, format_str.str, args);
+		}
+		catch (const std::format_error& error)
+		{
+			// The slot is claimed and has to be published, or the flusher waits on it forever
+			std::string message;
+			AppendFormatError(message, format_str.str, error);
+			out.cur = text;
+			for (const char c : message)
+			{
+				out = c;
+			}
+		}
+		slot->size = static_cast<uint32_t>(sizeof(header) + (out.cur - text));
+		LogQueue::Publish(slot);
+	}
+
+	void AppendFormatError(std::string& out, std::string_view format, const std::format_error& error)
+	{
+		out += format;
+		out += " [format error: ";
+		out += error.what();
+		out += ']';
+	}
+}
+
+namespace logging
+{
+	void AddSink(std::shared_ptr<LogSink> sink)
+	{
+		std::lock_guard lock(detail::sinksMutex);
+		if (sink == detail::consoleSink)
+		{
+			detail::consoleSinkRemoved = false;
+		}
+		if (std::find(detail::sinks.begin(), detail::sinks.end(), sink) == detail::sinks.end())
+		{
+			detail::sinks.push_back(std::move(sink));
+			detail::sinksVersion.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	void RemoveSink(const std::shared_ptr<LogSink>& sink)
+	{
+		std::lock_guard lock(detail::sinksMutex);
+		if (sink == detail::consoleSink)
+		{
+			detail::consoleSinkRemoved = true;
+		}
+		std::erase(detail::sinks, sink);
+		detail::sinksVersion.fetch_add(1, std::memory_order_release);
+	}
+
+	std::shared_ptr<LogSink> GetConsoleSink()
+	{
+		return detail::consoleSink;
+	}
+
+	void StartAsync()
+	{
+		if (detail::flusher.joinable())
+		{
+			return;
+		}
+		if (!detail::consoleSinkRemoved)
+		{
+			AddSink(detail::consoleSink);
+		}
+		detail::stopRequested.store(false, std::memory_order_relaxed);
+		detail::flusher = std::thread(detail::FlusherMain);
+		detail::asyncEnabled.store(true, std::memory_order_release);
+	}
+
+	void StopAsync()
+	{
+		detail::asyncEnabled.store(false, std::memory_order_seq_cst);
+		// Producers that saw the flag still set publish their record before the flusher's final drain
+		while (detail::activeProducers.load(std::memory_order_seq_cst) != 0)
+		{
+			std::this_thread::yield();
+		}
+		if (!detail::flusher.joinable())
+		{
+			return;
+		}
+		detail::stopRequested.store(true, std::memory_order_release);
+		detail::flusher.join();
+	}
+
+	uint64_t DroppedCount()
+	{
+		return detail::queue.dropped.load(std::memory_order_relaxed);
+	}
+
+	void SetLevel(LogLevel level)
+	{
+		detail::minLevel.store(level, std::memory_order_relaxed);
+	}
+
+	LogLevel GetLevel()
+	{
+		return detail::minLevel.load(std::memory_order_relaxed);
+	}
+
+	void RegisterLevelCvar(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name)
+	{
+		const auto defaultLevel = std::to_string(static_cast<int>(GetLevel()));
+		auto cvar = cvarManager->registerCvar(name, defaultLevel, "Minimum log level: 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 off",
+			true, true, 0, true, static_cast<float>(LogLevel::Off));
+		cvar.addOnValueChanged([](std::string, CVarWrapper newCvar)
+		{
+			SetLevel(static_cast<LogLevel>(newCvar.getIntValue()));
+		});
+		SetLevel(static_cast<LogLevel>(cvar.getIntValue()));
+	}
+}
@@ -4,29 +4,70 @@
 #include <source_location>
 #include <format>
 #include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <iterator>
+#include <type_traits>
+#include <chrono>
 
 #include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+#include "unicode.h"
 
 extern std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+// Starting log level: true starts at Debug, false at Info. Change it at runtime with logging::SetLevel
+// or the cvar registered by logging::RegisterLevelCvar.
 constexpr bool DEBUG_LOG = false;
 
+enum class LogLevel : uint8_t
+{
+	Trace,
+	Debug,
+	Info,
+	Warn,
+	Error,
+	Off
+};
+
+// Token bucket for LOG_THROTTLED: `perSecond` messages per second on average, bursts of up to `burst`.
+struct RateLimit
+{
+	float perSecond = 1.0f;
+	float burst = 1.0f;
+};
+
+namespace logging::detail
+{
+	// "[function (file:line)]" for a call site. Built on first use and kept for the lifetime of the plugin,
+	// so repeated calls from the same site are a table lookup. If the call site table is full the text
+	// lives in a thread local and is only valid until the next call.
+	[[nodiscard]] std::string_view InternLocation(const std::source_location& loc);
+}
 
 struct FormatString
 {
 	std::string_view str;
 	std::source_location loc{};
+	// The text outlives the program (a string literal), so deferred log records may point at it instead of copying it.
+	bool isStatic = false;
 
-	FormatString(const char* str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+	// String literals and constexpr arrays. consteval so that a buffer filled at runtime can't be taken for static text:
+	// pass those as a std::string_view or char*, which copies them into the record.
+	template <size_t N>
+	consteval FormatString(const char (&str)[N], const std::source_location& loc = std::source_location::current())
+		: str(str, std::char_traits<char>::length(str)), loc(loc), isStatic(true)
 	{
 	}
 
-	FormatString(const std::string&& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+	template <typename T> requires std::is_convertible_v<const T&, std::string_view> && (!std::is_array_v<T>)
+	FormatString(const T& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
 	{
 	}
 
-	[[nodiscard]] std::string GetLocation() const
+	[[nodiscard]] std::string_view GetLocation() const
 	{
-		return std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line());
+		return logging::detail::InternLocation(loc);
 	}
 };
 
@@ -35,53 +76,438 @@ struct FormatWstring
 	std::wstring_view str;
 	std::source_location loc{};
 
-	FormatWstring(const wchar_t* str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+	template <typename T> requires std::is_convertible_v<const T&, std::wstring_view>
+	FormatWstring(const T& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
 	{
 	}
 
-	FormatWstring(const std::wstring&& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+	[[nodiscard]] std::wstring GetLocation() const
 	{
+		return unicode::ToUtf16(logging::detail::InternLocation(loc));
 	}
+};
 
-	[[nodiscard]] std::wstring GetLocation() const
+
+namespace logging
+{
+	// Destination for log output. Write and Flush are only called from the flusher thread.
+	class LogSink
 	{
-		auto basic_string = std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line());
-		return std::wstring(basic_string.begin(), basic_string.end());
+	public:
+		virtual ~LogSink() = default;
+
+		// One formatted message, UTF-8, without a trailing newline.
+		virtual void Write(LogLevel level, std::string_view text) = 0;
+		// Called when the ring runs dry and before the flusher stops.
+		virtual void Flush() {}
+
+		// Messages below this level are not written to this sink.
+		std::atomic<LogLevel> minLevel = LogLevel::Trace;
+	};
+
+	// The console sink is added by StartAsync unless it was removed explicitly.
+	void AddSink(std::shared_ptr<LogSink> sink);
+	void RemoveSink(const std::shared_ptr<LogSink>& sink);
+	[[nodiscard]] std::shared_ptr<LogSink> GetConsoleSink();
+
+	// LOG/DEBUGLOG copy their arguments into a record in a bounded ring and return; a background thread
+	// does the formatting and hands the text to the console.
+	// Call StartAsync() in onLoad (after _globalCvarManager is set) and StopAsync() in onUnload.
+	// While the flusher isn't running, LOG formats and writes straight to the console like it always did,
+	// the other sinks only get output through the flusher.
+	void StartAsync();
+	void StopAsync();
+
+	// Messages thrown away because the ring was full. The flusher also reports these to the console.
+	[[nodiscard]] uint64_t DroppedCount();
+
+	void SetLevel(LogLevel level);
+	[[nodiscard]] LogLevel GetLevel();
+	// Registers an int cvar (0 trace .. 5 off) that drives SetLevel.
+	void RegisterLevelCvar(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name);
+
+	namespace detail
+	{
+		extern std::atomic<LogLevel> minLevel;
+
+		[[nodiscard]] inline bool IsEnabled(LogLevel level)
+		{
+			return level >= minLevel.load(std::memory_order_relaxed);
+		}
+
+		// Debug, trace and error output gets the call site appended
+		[[nodiscard]] constexpr bool WithLocation(LogLevel level)
+		{
+			return level == LogLevel::Trace || level == LogLevel::Debug || level == LogLevel::Error;
+		}
+
+		// Per call site state for LOG_THROTTLED and LOG_SAMPLED, found by source_location in a fixed-size table.
+		// If the table fills up, call sites that didn't get an entry are never limited.
+		[[nodiscard]] bool AcquireRateLimit(const std::source_location& loc, RateLimit limit);
+		[[nodiscard]] bool AcquireSample(const std::source_location& loc, uint32_t everyN);
+
+		constexpr size_t SLOT_SIZE = 512;      // bytes per record, longer messages are truncated
+		constexpr size_t QUEUE_CAPACITY = 2048; // slots, power of two. 1 MiB in total
+
+		struct alignas(64) LogSlot
+		{
+			std::atomic<size_t> sequence;
+			uint32_t size = 0;
+			std::byte payload[SLOT_SIZE - sizeof(std::atomic<size_t>) - sizeof(uint32_t)];
+		};
+
+		// Bounded multi-producer single-consumer ring (Vyukov style sequence numbers).
+		// Producers never block: if the ring is full the message is dropped and counted.
+		class LogQueue
+		{
+		public:
+			LogQueue();
+
+			// Reserves the next slot for writing, or returns nullptr if the ring is full.
+			LogSlot* Claim();
+			// Hands a claimed slot to the consumer.
+			static void Publish(LogSlot* slot);
+
+			// Consumer side. Returns nullptr if nothing is ready.
+			LogSlot* Peek();
+			void Release(LogSlot* slot);
+
+			std::atomic<uint64_t> dropped{0};
+
+		private:
+			LogSlot slots_[QUEUE_CAPACITY];
+			alignas(64) std::atomic<size_t> enqueuePos_{0};
+			alignas(64) size_t dequeuePos_ = 0;
+		};
+
+		extern LogQueue queue;
+		extern std::atomic<bool> asyncEnabled;
+		extern std::atomic<uint32_t> activeProducers;
+
+		// Held while a thread writes a record to the ring, true if the async backend is running. StopAsync clears
+		// asyncEnabled and then waits for the holders, so a record that got past the check still makes the final drain.
+		class AsyncProducer
+		{
+		public:
+			AsyncProducer()
+			{
+				if (!asyncEnabled.load(std::memory_order_relaxed))
+				{
+					return;
+				}
+				// Registered before the second check: StopAsync stores the flag before reading the count, so one sees the other
+				activeProducers.fetch_add(1, std::memory_order_seq_cst);
+				entered_ = asyncEnabled.load(std::memory_order_seq_cst);
+				if (!entered_)
+				{
+					activeProducers.fetch_sub(1, std::memory_order_release);
+				}
+			}
+
+			~AsyncProducer()
+			{
+				if (entered_)
+				{
+					activeProducers.fetch_sub(1, std::memory_order_release);
+				}
+			}
+
+			AsyncProducer(const AsyncProducer&) = delete;
+			AsyncProducer& operator=(const AsyncProducer&) = delete;
+
+			explicit operator bool() const { return entered_; }
+
+		private:
+			bool entered_ = false;
+		};
+
+		// Turns the serialized arguments of a record back into text.
+		// Records only live in the ring: they hold function pointers and the addresses of literal format strings,
+		// which mean nothing outside this process, so the flusher formats them before any sink sees them. Sinks,
+		// the log file included, receive text, and there is no on-disk binary format or offline decoder.
+		using DecodeFn = void (*)(std::string_view format, const std::byte* args, std::string& out);
+
+		// Every record starts with this, followed by the format text (unless it is static) and the arguments.
+		struct RecordHeader
+		{
+			DecodeFn decode;          // nullptr: the payload is already formatted text
+			const char* format;       // static format string, nullptr when the text follows the header
+			uint32_t formatSize;
+			LogLevel level;
+			bool withLocation;        // append the call site, DEBUGLOG does this
+			std::source_location location;
+		};
+
+		constexpr size_t MAX_RECORD_SIZE = sizeof(LogSlot::payload);
+
+		// Describes how an argument type is copied into a record and what it is formatted as later.
+		// Types without a codec make the call fall back to formatting on the calling thread.
+		template <typename T>
+		struct ArgCodec
+		{
+			static constexpr bool supported = false;
+		};
+
+		template <typename T>
+		struct TrivialCodec
+		{
+			static constexpr bool supported = true;
+			using Decoded = T;
+
+			static size_t Size(const T&) { return sizeof(T); }
+
+			static std::byte* Write(std::byte* out, const T& value)
+			{
+				std::memcpy(out, &value, sizeof(T));
+				return out + sizeof(T);
+			}
+
+			static T Read(const std::byte*& in)
+			{
+				T value;
+				std::memcpy(&value, in, sizeof(T));
+				in += sizeof(T);
+				return value;
+			}
+		};
+
+		struct StringCodec
+		{
+			static constexpr bool supported = true;
+			using Decoded = std::string_view;
+
+			static size_t Size(std::string_view value) { return sizeof(uint32_t) + value.size(); }
+
+			static std::byte* Write(std::byte* out, std::string_view value)
+			{
+				const auto size = static_cast<uint32_t>(value.size());
+				std::memcpy(out, &size, sizeof(size));
+				std::memcpy(out + sizeof(size), value.data(), value.size());
+				return out + sizeof(size) + value.size();
+			}
+
+			static std::string_view Read(const std::byte*& in)
+			{
+				uint32_t size;
+				std::memcpy(&size, in, sizeof(size));
+				const auto* data = reinterpret_cast<const char*>(in + sizeof(size));
+				in += sizeof(size) + size;
+				return {data, size};
+			}
+		};
+
+		template <typename T> requires std::is_arithmetic_v<T>
+		struct ArgCodec<T> : TrivialCodec<T> {};
+		template <> struct ArgCodec<const void*> : TrivialCodec<const void*> {};
+		template <> struct ArgCodec<void*> : TrivialCodec<void*> {};
+		template <> struct ArgCodec<std::nullptr_t> : TrivialCodec<std::nullptr_t> {};
+		template <> struct ArgCodec<std::string> : StringCodec {};
+		template <> struct ArgCodec<std::string_view> : StringCodec {};
+		template <> struct ArgCodec<const char*> : StringCodec {};
+		template <> struct ArgCodec<char*> : StringCodec {};
+		template <size_t N> struct ArgCodec<char[N]> : StringCodec {};
+
+		template <typename... Args>
+		constexpr bool DEFERRABLE = (ArgCodec<std::remove_cvref_t<Args>>::supported && ...);
+
+		template <typename... Args>
+		void Decode(std::string_view format, [[maybe_unused]] const std::byte* in, std::string& out)
+		{
+			// Braced initialization reads the arguments left to right
+			std::tuple<typename ArgCodec<Args>::Decoded...> values{ArgCodec<Args>::Read(in)...};
+			std::apply([&](auto&... value)
+			{
+				std::vformat_to(std::back_inserter(out), format, std::make_format_args(value...));
+			}, values);
+		}
+
+		// What a message whose format string doesn't match its arguments is logged as: the raw format string and the error
+		void AppendFormatError(std::string& out, std::string_view format, const std::format_error& error);
+
+		// Copies the arguments into a ring slot, formatting happens on the flusher.
+		// Returns false if the record doesn't fit in a slot and the caller has to format it itself.
+		template <typename... Args>
+		bool PushDeferred(LogLevel level, const FormatString& format_str, bool withLocation, const Args&... args)
+		{
+			const size_t formatSize = format_str.isStatic ? 0 : format_str.str.size();
+			const size_t size = sizeof(RecordHeader) + formatSize + (ArgCodec<std::remove_cvref_t<Args>>::Size(args) + ... + 0);
+			if (size > MAX_RECORD_SIZE)
+			{
+				return false;
+			}
+
+			LogSlot* slot = queue.Claim();
+			if (!slot)
+			{
+				return true;
+			}
+
+			const RecordHeader header{
+				&Decode<std::remove_cvref_t<Args>...>,
+				format_str.isStatic ? format_str.str.data() : nullptr,
+				static_cast<uint32_t>(format_str.str.size()),
+				level,
+				withLocation,
+				format_str.loc
+			};
+			std::byte* out = slot->payload;
+			std::memcpy(out, &header, sizeof(header));
+			out += sizeof(header);
+			if (formatSize != 0)
+			{
+				std::memcpy(out, format_str.str.data(), formatSize);
+				out += formatSize;
+			}
+			((out = ArgCodec<std::remove_cvref_t<Args>>::Write(out, args)), ...);
+
+			slot->size = static_cast<uint32_t>(out - slot->payload);
+			LogQueue::Publish(slot);
+			return true;
+		}
+
+		// Formats on the calling thread straight into a ring slot, for arguments that can't be deferred.
+		void PushFormatted(LogLevel level, const FormatString& format_str, bool withLocation, std::format_args args);
+
+		// Queues text that is already formatted (UTF-8).
+		void PushText(LogLevel level, const std::source_location& loc, bool withLocation, std::string_view text);
+
+		// Callers have already checked IsEnabled(level)
+		template <typename... Args>
+		void Log(LogLevel level, const FormatString& format_str, bool withLocation, Args&... args)
+		{
+			if (const AsyncProducer producer; producer)
+			{
+				if constexpr (DEFERRABLE<Args...>)
+				{
+					if (PushDeferred(level, format_str, withLocation, args...))
+					{
+						return;
+					}
+				}
+				PushFormatted(level, format_str, withLocation, std::make_format_args(args...));
+				return;
+			}
+
+			// log() takes its string by value, so that copy is the only allocation once the buffer has grown
+			thread_local std::string text;
+			text.clear();
+			std::vformat_to(std::back_inserter(text), format_str.str, std::make_format_args(args...));
+			if (withLocation)
+			{
+				text += ' ';
+				text += format_str.GetLocation();
+			}
+			_globalCvarManager->log(text);
+		}
+
+		// Wide messages are formatted on the calling thread and converted to UTF-8, from there on
+		// they take the same path as narrow ones
+		template <typename... Args>
+		void LogWide(LogLevel level, const FormatWstring& format_str, bool withLocation, Args&... args)
+		{
+			thread_local std::wstring wide;
+			thread_local std::string text;
+			wide.clear();
+			text.clear();
+			std::vformat_to(std::back_inserter(wide), format_str.str, std::make_wformat_args(args...));
+			unicode::AppendUtf8(wide, text);
+
+			if (const AsyncProducer producer; producer)
+			{
+				PushText(level, format_str.loc, withLocation, text);
+				return;
+			}
+			if (withLocation)
+			{
+				text += ' ';
+				text += InternLocation(format_str.loc);
+			}
+			_globalCvarManager->log(text);
+		}
 	}
-};
+}
 
+template <typename... Args>
+void LOG(const FormatString& format_str, Args&&... args)
+{
+	if (logging::detail::IsEnabled(LogLevel::Info))
+	{
+		logging::detail::Log(LogLevel::Info, format_str, false, args...);
+	}
+}
 
 template <typename... Args>
-void LOG(std::string_view format_str, Args&&... args)
+void LOG(const FormatWstring& format_str, Args&&... args)
 {
-	_globalCvarManager->log(std::vformat(format_str, std::make_format_args(args...)));
+	if (logging::detail::IsEnabled(LogLevel::Info))
+	{
+		logging::detail::LogWide(LogLevel::Info, format_str, false, args...);
+	}
 }
 
 template <typename... Args>
-void LOG(std::wstring_view format_str, Args&&... args)
+void WARNLOG(const FormatString& format_str, Args&&... args)
 {
-	_globalCvarManager->log(std::vformat(format_str, std::make_wformat_args(args...)));
+	if (logging::detail::IsEnabled(LogLevel::Warn))
+	{
+		logging::detail::Log(LogLevel::Warn, format_str, false, args...);
+	}
+}
+
+template <typename... Args>
+void ERRORLOG(const FormatString& format_str, Args&&... args)
+{
+	if (logging::detail::IsEnabled(LogLevel::Error))
+	{
+		logging::detail::Log(LogLevel::Error, format_str, true, args...);
+	}
 }
 
 
 template <typename... Args>
 void DEBUGLOG(const FormatString& format_str, Args&&... args)
 {
-	if constexpr (DEBUG_LOG)
+	if (logging::detail::IsEnabled(LogLevel::Debug))
 	{
-		auto text = std::vformat(format_str.str, std::make_format_args(args...));
-		auto location = format_str.GetLocation();
-		_globalCvarManager->log(std::format("{} {}", text, location));
+		logging::detail::Log(LogLevel::Debug, format_str, true, args...);
 	}
 }
 
 template <typename... Args>
 void DEBUGLOG(const FormatWstring& format_str, Args&&... args)
 {
-	if constexpr (DEBUG_LOG)
+	if (logging::detail::IsEnabled(LogLevel::Debug))
+	{
+		logging::detail::LogWide(LogLevel::Debug, format_str, true, args...);
+	}
+}
+
+template <typename... Args>
+void TRACELOG(const FormatString& format_str, Args&&... args)
+{
+	if (logging::detail::IsEnabled(LogLevel::Trace))
+	{
+		logging::detail::Log(LogLevel::Trace, format_str, true, args...);
+	}
+}
+
+
+// For call sites in per-tick hooks. Messages over the rate limit are dropped without being formatted.
+template <typename... Args>
+void LOG_THROTTLED(LogLevel level, RateLimit limit, const FormatString& format_str, Args&&... args)
+{
+	if (logging::detail::IsEnabled(level) && logging::detail::AcquireRateLimit(format_str.loc, limit))
+	{
+		logging::detail::Log(level, format_str, logging::detail::WithLocation(level), args...);
+	}
+}
+
+// Logs only every Nth call from this call site.
+template <typename... Args>
+void LOG_SAMPLED(LogLevel level, uint32_t everyN, const FormatString& format_str, Args&&... args)
+{
+	if (logging::detail::IsEnabled(level) && logging::detail::AcquireSample(format_str.loc, everyN))
 	{
-		auto text = std::vformat(format_str.str, std::make_wformat_args(args...));
-		auto location = format_str.GetLocation();
-		_globalCvarManager->log(std::format(L"{} {}", text, location));
+		logging::detail::Log(level, format_str, logging::detail::WithLocation(level), args...);
 	}
 }
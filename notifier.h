@@ -0,0 +1,243 @@
+#pragma once
+#include <array>
+#include <charconv>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+#include "logging.h"
+
+// Notifier registration that hands the handler views of the arguments instead of copies.
+// registerNotifier stays the backend, so the SDK still builds its std::vector<std::string> once per call; what goes away
+// is everything after that: no copy of the vector into the handler, no std::stoi/std::stof temporaries, no try/catch.
+//
+//   notifier::Register(cvarManager, "myplugin_cmd", [](notifier::Args args) { ... args[1] ... }, "desc", PERMISSION_ALL);
+//
+//   // myplugin_spawn <count> <speed> [mode]
+//   notifier::RegisterTyped(cvarManager, "myplugin_spawn", [](int count, float speed, std::optional<Mode> mode) { ... },
+//       "Spawns balls", PERMISSION_ALL);
+//
+// Typed handlers take int/float/double/bool/enum/std::string_view parameters, optionally wrapped in std::optional for
+// trailing arguments that may be left out. Anything else fails to compile. Enums are parsed as their integer value, or
+// by name if the enum has a `bool ParseNotifierArg(std::string_view, E&)` next to it.
+// When an argument doesn't parse, a usage message is logged and the handler isn't called.
+namespace notifier
+{
+	// args[0] is the notifier name, like in the std::vector<std::string> callbacks
+	using Args = std::span<const std::string_view>;
+
+	namespace detail
+	{
+		// Enough for nearly every command, more arguments than this fall back to the heap
+		constexpr size_t INLINE_ARGS = 16;
+
+		template <typename T>
+		struct IsOptional : std::false_type {};
+		template <typename T>
+		struct IsOptional<std::optional<T>> : std::true_type {};
+
+		template <typename T>
+		concept HasNamedParser = requires(std::string_view text, T& out) { { ParseNotifierArg(text, out) } -> std::convertible_to<bool>; };
+
+		template <typename T>
+		constexpr bool PARSEABLE = std::is_same_v<T, std::string_view> || std::is_arithmetic_v<T> || std::is_enum_v<T>;
+		template <typename T>
+		constexpr bool PARSEABLE<std::optional<T>> = PARSEABLE<T>;
+
+		template <typename T>
+		constexpr std::string_view TypeName()
+		{
+			if constexpr (std::is_same_v<T, bool>) return "bool";
+			else if constexpr (std::is_integral_v<T>) return "integer";
+			else if constexpr (std::is_floating_point_v<T>) return "number";
+			else if constexpr (std::is_enum_v<T>) return "enum";
+			else return "string";
+		}
+
+		template <typename Number>
+		bool ParseNumber(std::string_view text, Number& out)
+		{
+			if (!text.empty() && text.front() == '+')
+			{
+				text.remove_prefix(1);
+			}
+			const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+			return ec == std::errc() && end == text.data() + text.size();
+		}
+
+		template <typename T>
+		bool Parse(std::string_view text, T& out)
+		{
+			if constexpr (std::is_same_v<T, std::string_view>)
+			{
+				out = text;
+				return true;
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				if (text == "1" || text == "true" || text == "on")
+				{
+					out = true;
+					return true;
+				}
+				if (text == "0" || text == "false" || text == "off")
+				{
+					out = false;
+					return true;
+				}
+				return false;
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				if constexpr (HasNamedParser<T>)
+				{
+					if (ParseNotifierArg(text, out))
+					{
+						return true;
+					}
+				}
+				std::underlying_type_t<T> value{};
+				if (!ParseNumber(text, value))
+				{
+					return false;
+				}
+				out = static_cast<T>(value);
+				return true;
+			}
+			else
+			{
+				return ParseNumber(text, out);
+			}
+		}
+
+		template <typename T>
+		struct Signature : Signature<decltype(&T::operator())> {};
+		template <typename R, typename... Params>
+		struct Signature<R (*)(Params...)> { using Types = std::tuple<std::remove_cvref_t<Params>...>; };
+		template <typename R, typename C, typename... Params>
+		struct Signature<R (C::*)(Params...)> : Signature<R (*)(Params...)> {};
+		template <typename R, typename C, typename... Params>
+		struct Signature<R (C::*)(Params...) const> : Signature<R (*)(Params...)> {};
+
+		template <typename Tuple, size_t... I>
+		constexpr size_t RequiredCount(std::index_sequence<I...>)
+		{
+			size_t required = 0;
+			((required += IsOptional<std::tuple_element_t<I, Tuple>>::value ? 0 : 1), ...);
+			return required;
+		}
+
+		template <typename Tuple, size_t... I>
+		constexpr bool OptionalsTrail(std::index_sequence<I...>)
+		{
+			bool seenOptional = false;
+			bool ok = true;
+			((ok = ok && !(seenOptional && !IsOptional<std::tuple_element_t<I, Tuple>>::value),
+				seenOptional = seenOptional || IsOptional<std::tuple_element_t<I, Tuple>>::value), ...);
+			return ok;
+		}
+
+		template <typename T>
+		bool ParseAt(Args args, size_t index, T& out)
+		{
+			// args[0] is the notifier name
+			const size_t position = index + 1;
+			if constexpr (IsOptional<T>::value)
+			{
+				if (position >= args.size())
+				{
+					return true;
+				}
+				out.emplace();
+				if (Parse(args[position], *out))
+				{
+					return true;
+				}
+				WARNLOG("{}: argument {} '{}' is not a valid {}", args[0], position, args[position], TypeName<typename T::value_type>());
+				return false;
+			}
+			else
+			{
+				if (Parse(args[position], out))
+				{
+					return true;
+				}
+				WARNLOG("{}: argument {} '{}' is not a valid {}", args[0], position, args[position], TypeName<T>());
+				return false;
+			}
+		}
+
+		template <typename Handler, typename Tuple, size_t... I>
+		void InvokeTyped(Handler& handler, Args args, std::index_sequence<I...> indices)
+		{
+			constexpr size_t required = RequiredCount<Tuple>(indices);
+			constexpr size_t total = sizeof...(I);
+			if (args.size() - 1 < required || args.size() - 1 > total)
+			{
+				WARNLOG("{}: expected {} to {} arguments, got {}", args[0], required, total, args.size() - 1);
+				return;
+			}
+			Tuple values{};
+			if ((ParseAt(args, I, std::get<I>(values)) && ...))
+			{
+				std::apply(handler, std::move(values));
+			}
+		}
+
+		template <typename Handler>
+		auto Adapt(Handler handler)
+		{
+			return [handler = std::move(handler)](std::vector<std::string> args) mutable
+			{
+				// Views on the stack, so a handler that triggers its own notifier can't invalidate them
+				std::array<std::string_view, INLINE_ARGS> inlineViews;
+				std::vector<std::string_view> heapViews;
+				if (args.size() > INLINE_ARGS)
+				{
+					heapViews.resize(args.size());
+				}
+				const std::span<std::string_view> views = heapViews.empty()
+					? std::span<std::string_view>(inlineViews.data(), args.size())
+					: std::span<std::string_view>(heapViews);
+				for (size_t i = 0; i < args.size(); ++i)
+				{
+					views[i] = args[i];
+				}
+				handler(Args(views));
+			};
+		}
+	}
+
+	// The handler gets every argument as a view into the SDK's vector, valid for the duration of the call.
+	template <typename Handler> requires std::is_invocable_v<Handler&, Args>
+	void Register(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name, Handler handler,
+		const std::string& description, unsigned char permissions)
+	{
+		cvarManager->registerNotifier(name, detail::Adapt(std::move(handler)), description, permissions);
+	}
+
+	// The handler's parameter list is the command's syntax, checked at compile time.
+	template <typename Handler>
+	void RegisterTyped(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name, Handler handler,
+		const std::string& description, unsigned char permissions)
+	{
+		using Tuple = typename detail::Signature<Handler>::Types;
+		using Indices = std::make_index_sequence<std::tuple_size_v<Tuple>>;
+		static_assert([]<size_t... I>(std::index_sequence<I...>)
+		{
+			return (detail::PARSEABLE<std::tuple_element_t<I, Tuple>> && ...);
+		}(Indices{}), "notifier parameters must be int, float, double, bool, an enum or std::string_view, optionally in std::optional");
+		static_assert(detail::OptionalsTrail<Tuple>(Indices{}), "std::optional notifier parameters must come after the required ones");
+
+		Register(cvarManager, name, [handler = std::move(handler)](Args args) mutable
+		{
+			detail::InvokeTyped<Handler, Tuple>(handler, args, Indices{});
+		}, description, permissions);
+	}
+}
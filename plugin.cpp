@@ -9,9 +9,20 @@ std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
 void $projectname$::onLoad()
 {
 	_globalCvarManager = cvarManager;
+	logging::StartAsync();
 	//LOG("Plugin loaded!");
-	// !! Enable debug logging by setting DEBUG_LOG = true in logging.h !!
+	// !! Enable debug logging by setting DEBUG_LOG = true in logging.h, or at runtime with the log level cvar below !!
 	//DEBUGLOG("$projectname$ debug mode enabled");
+	//logging::RegisterLevelCvar(cvarManager, "$projectname$_log_level");
+
+	// Besides the console, log output can go to a rotating file and/or a buffer the plugin window shows (LogSinks.h)
+	//logging::AddSink(std::make_shared<MappedFileSink>(gameWrapper->GetDataFolder() / "$projectname$" / "log.txt"));
+	//logSink = std::make_shared<MemoryLogSink>(); // and logSink->Render() in RenderWindow
+	//logging::AddSink(logSink);
+
+	// In hooks that fire every tick, limit how often a call site can log
+	//LOG_THROTTLED(LogLevel::Info, {2.0f, 5.0f}, "ball speed {}", speed); // 2 per second, bursts of 5
+	//LOG_SAMPLED(LogLevel::Debug, 120, "tick {}", tick); // every 120th call
 
 	// LOG and DEBUGLOG use fmt format strings https://fmt.dev/latest/index.html
 	//DEBUGLOG("1 = {}, 2 = {}, pi = {}, false != {}", "one", 2, 3.14, true);
@@ -20,6 +31,11 @@ void $projectname$::onLoad()
 	//	LOG("Hello notifier!");
 	//}, "", 0);
 
+	// Notifiers bound to keys or run from scripts can take their arguments as views, or parsed to the handler's parameter types (notifier.h)
+	//notifier::RegisterTyped(cvarManager, "$projectname$_spawn", [this](int count, float speed, std::optional<bool> random) {
+	//	LOG("spawning {} balls at {}", count, speed);
+	//}, "Usage: $projectname$_spawn <count> <speed> [random]", PERMISSION_ALL);
+
 	//auto cvar = cvarManager->registerCvar("template_cvar", "hello-cvar", "just a example of a cvar");
 	//auto cvar2 = cvarManager->registerCvar("template_cvar2", "0", "just a example of a cvar with more settings", true, true, -10, true, 10 );
 
@@ -34,11 +50,33 @@ void $projectname$::onLoad()
 	//enabled = std::make_shared<bool>(false);
 	//cvarManager->registerCvar("TEMPLATE_Enabled", "0", "Enable the TEMPLATE plugin", true, true, 0, true, 1).bindTo(enabled);
 
+	// Cvars read every tick are cheaper through a CvarCache: a plain struct field instead of a lookup by name (CvarCache.h)
+	//settings.Bind(&Settings::enabled, cvarManager->registerCvar("$projectname$_enabled", "0", "Enable the plugin", true, true, 0, true, 1));
+	//settings.Bind(&Settings::scale, cvarManager->registerCvar("$projectname$_scale", "1.0", "Scale"));
+	//if (settings.Get().enabled) { ... } // or settings.Snapshot() from another thread
+
+	// Settings that outgrow cvars (lists, presets, blobs) go in a SettingsStore, only the changed pages are written back (SettingsStore.h)
+	//settingsStore.Open(gameWrapper->GetDataFolder() / "$projectname$" / "settings.bin");
+	//const std::string imported[] = {"$projectname$_enabled", "$projectname$_scale"};
+	//settingsStore.ImportCvars(cvarManager, imported); // once, keeps what users had in their cvars
+	//settingsStore.SetString("preset.0.name", "Kickoffs");
+	//settingsStore.FlushAsync(*jobs); // or settingsStore.Flush()
+
 	//cvarManager->registerNotifier("NOTIFIER", [this](std::vector<std::string> params){FUNCTION();}, "DESCRIPTION", PERMISSION_ALL);
 	//cvarManager->registerCvar("CVAR", "DEFAULTVALUE", "DESCRIPTION", true, true, MINVAL, true, MAXVAL);//.bindTo(CVARVARIABLE);
 	//gameWrapper->HookEvent("FUNCTIONNAME", std::bind(&TEMPLATE::FUNCTION, this));
 	//gameWrapper->HookEventWithCallerPost<ActorWrapper>("FUNCTIONNAME", std::bind(&$projectname$::FUNCTION, this, _1, _2, _3));
 	//gameWrapper->RegisterDrawable(bind(&TEMPLATE::Render, this, std::placeholders::_1));
+	// Or record overlay draws into a CanvasCommands on any thread and let a CanvasBatch draw them with fewer canvas calls (CanvasBatch.h)
+	//gameWrapper->RegisterDrawable([this](CanvasWrapper canvas) { canvasBatch.Draw(canvas); });
+	//CanvasCommands overlay;
+	//overlay.SetColor(255, 200, 0);
+	//overlay.DrawString({20, 20}, "hello canvas");
+	//canvasBatch.Submit(0, std::move(overlay));
+	// PluginWindowBase::Render and RenderWindow are timed as GUI zones, time your own ImGui sections the same way and
+	// draw the flame graph in your window (GuiProfiler.h). RenderSettings is called by BakkesMod directly, give it a zone yourself.
+	//GuiZone zone("RenderSettings");
+	//GuiProfiler::Get().Render();
 
 
 	//gameWrapper->HookEvent("Function TAGame.Ball_TA.Explode", [this](std::string eventName) {
@@ -46,4 +84,68 @@ void $projectname$::onLoad()
 	//});
 	// You could also use std::bind here
 	//gameWrapper->HookEvent("Function TAGame.Ball_TA.Explode", std::bind(&$projectname$::YourPluginMethod, this);
+
+	// Where will the ball go? BallPredictor gives 6 seconds of positions at 120 Hz, PredictBatch does many starts at once (BallPrediction.h)
+	//gameWrapper->HookEvent("Function TAGame.Ball_TA.Tick", [this](std::string) {
+	//	auto server = gameWrapper->GetCurrentGameState();
+	//	if (!server) return;
+	//	auto ball = server.GetBall();
+	//	if (!ball) return;
+	//	const Vector location = ball.GetLocation(), velocity = ball.GetVelocity(), spin = ball.GetAngularVelocity();
+	//	BallState start{{location.X, location.Y, location.Z}, {velocity.X, velocity.Y, velocity.Z}, {spin.X, spin.Y, spin.Z}};
+	//	ballPredictor.Predict(start, ballPath); // std::vector<BallState> ballPath(BallPredictor::DEFAULT_STEPS) declared in the header
+	//});
+
+	// Capture ball and car state once per tick, then read it as float arrays from anywhere (GameStateHistory.h)
+	//gameWrapper->HookEvent(EventBus::TICK_EVENT, [this](std::string) { history.Capture(gameWrapper->GetCurrentGameState()); });
+	//jobs->Submit([this] { return history.MaxSpeed(GameStateHistory::BALL, 5 * 120); }, [](std::optional<float> speed) { /* ... */ });
+	// and record the session for offline analysis, TelemetryReader opens it again with seeking by tick (Telemetry.h)
+	//recorder.Open(gameWrapper->GetDataFolder() / "$projectname$" / "session.bmtl"); // then recorder.Capture(history) after each history.Capture
+
+	// Hooks registered through a HookProfiler are timed. "$projectname$_hookstats" prints the stats, "csv" exports them,
+	// hookProfiler->Render() shows them in your window
+	//hookProfiler = std::make_unique<HookProfiler>(gameWrapper);
+	//hookProfiler->RegisterNotifier(cvarManager, "$projectname$_hookstats", gameWrapper->GetDataFolder() / "$projectname$" / "hookstats.csv");
+	//hookProfiler->HookEvent("Function TAGame.Ball_TA.Explode", [this](std::string eventName) {
+	//	LOG("Your hook got called and the ball went POOF");
+	//});
+	//hookProfiler->HookEventWithCallerPost<ActorWrapper>("FUNCTIONNAME", std::bind(&$projectname$::FUNCTION, this, _1, _2, _3));
+
+	// For a whole session: "$projectname$_trace start" records hooks, jobs, GUI zones and log flushes on every thread,
+	// "$projectname$_trace export" writes them for chrome://tracing or ui.perfetto.dev (tracing.h)
+	//tracing::RegisterNotifier(cvarManager, "$projectname$_trace", gameWrapper->GetDataFolder() / "$projectname$" / "trace.json");
+	//tracing::Zone zone("parse tables"); // times any other scope
+
+	// Several handlers on the same high frequency event? Share one hook through an EventBus
+	//eventBus = std::make_unique<EventBus>(gameWrapper, hookProfiler.get());
+	//eventBus->Subscribe<&$projectname$::FUNCTION>("Function TAGame.Car_TA.SetVehicleInput", this);
+	//eventBus->Subscribe("Function TAGame.Ball_TA.Tick", [this](ActorWrapper caller, void* params) { /* ... */ }, {.coalesce = true});
+
+	// Heavy work goes to a JobSystem, the result comes back on the game thread when the completions are drained
+	//jobs = std::make_unique<JobSystem>();
+	//gameWrapper->HookEvent(EventBus::TICK_EVENT, [this](std::string) { jobs->DrainCompletions(); });
+	//jobs->Submit([] { return ExpensiveComputation(); }, [this](auto result) { /* game thread, wrappers are safe to use */ });
+
+	// Keep onLoad short: register what the game needs now, load the rest in the background and log how long both took
+	//startup = std::make_unique<StartupPhases>(*jobs);
+	//startup->Sync("cvars", [this] { /* registerCvar, registerNotifier, hooks */ });
+	//startup->Async("data tables", [this](std::stop_token stop) { /* read files, return early if stop is requested */ });
+	//startup->Finish(); // "onLoad: 3.1 ms sync, 48.0 ms async" once the async tasks are done, check startup->AllSucceeded() (or each task's ready flag) before using their results
+
+	// Reloading while developing? Hand state over from the previous instance instead of rebuilding it (StateHandoff.h)
+	//handoff = std::make_unique<StateHandoff>(gameWrapper->GetDataFolder() / "$projectname$" / "handoff.bin");
+	//handoff->Load();
+	//handoff->RegisterCvars(cvarManager, {"$projectname$_enabled", "$projectname$_scale"});
+	//handoff->Register("window", 1, [this](BlobWriter& out) { out.Write(isWindowOpen_); });
+	//if (auto in = handoff->Restore("window", 1)) in->Read(isWindowOpen_);
+}
+
+void $projectname$::onUnload()
+{
+	// Stop the startup tasks that are still loading before the objects they fill in go away
+	//startup->Cancel();
+	//handoff->Save();
+	//settingsStore.Close();
+	// Flushes whatever is still queued, LOG writes to the console directly after this
+	logging::StopAsync();
 }
@@ -1,6 +1,21 @@
 #pragma once
 
 #include "GuiBase.h"
+#include "GuiProfiler.h"
+#include "LogSinks.h"
+#include "HookProfiler.h"
+#include "EventBus.h"
+#include "JobSystem.h"
+#include "StartupPhases.h"
+#include "StateHandoff.h"
+#include "BallPrediction.h"
+#include "GameStateHistory.h"
+#include "Telemetry.h"
+#include "CanvasBatch.h"
+#include "CvarCache.h"
+#include "SettingsStore.h"
+#include "notifier.h"
+#include "tracing.h"
 #include "bakkesmod/plugin/bakkesmodplugin.h"
 #include "bakkesmod/plugin/pluginwindow.h"
 #include "bakkesmod/plugin/PluginSettingsWindow.h"
@@ -15,12 +30,27 @@ class $projectname$: public BakkesMod::Plugin::BakkesModPlugin
 {
 
 	//std::shared_ptr<bool> enabled;
+	//struct Settings { bool enabled = false; float scale = 1.0f; };
+	//CvarCache<Settings> settings;
+	//SettingsStore settingsStore;
+	//std::shared_ptr<MemoryLogSink> logSink;
+	//std::unique_ptr<HookProfiler> hookProfiler;
+	//std::unique_ptr<EventBus> eventBus;
+	//std::unique_ptr<JobSystem> jobs;
+	//std::unique_ptr<StartupPhases> startup;
+	//std::unique_ptr<StateHandoff> handoff;
+	//BallPredictor ballPredictor;
+	//std::vector<BallState> ballPath = std::vector<BallState>(BallPredictor::DEFAULT_STEPS);
+	//GameStateHistory history;
+	//TelemetryRecorder recorder;
+	//CanvasBatch canvasBatch;
 
 	//Boilerplate
 	void onLoad() override;
-	//void onUnload() override; // Uncomment and implement if you need a unload method
+	void onUnload() override;
 
 public:
 	//void RenderSettings() override; // Uncomment if you wanna render your own tab in the settings menu
 	//void RenderWindow() override; // Uncomment if you want to render your own plugin window
+	//uint64_t ContentVersion() override; // With retainContent_ = true, the window is only rebuilt when this changes or on MarkDirty()
 };
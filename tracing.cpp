@@ -0,0 +1,367 @@
+#include "pch.h"
+#include "tracing.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tracing::detail
+{
+	std::atomic<bool> enabled = false;
+
+	namespace
+	{
+		enum class Kind : uint8_t
+		{
+			Complete,
+			Counter,
+		};
+
+		struct Event
+		{
+			const char* name;
+			const char* category;
+			const char* argNames[2];
+			int64_t args[2];  // a counter's value is args[0]
+			Clock::time_point start;
+			Clock::duration duration;
+			Kind kind;
+		};
+
+		constexpr size_t CHUNK_EVENTS = 4096;
+		// About a million events per thread, the rest are counted as dropped
+		constexpr size_t MAX_CHUNKS = 256;
+
+		// Appended to by its thread only. The exporter reads up to `count`, which is published after the event is written.
+		struct Chunk
+		{
+			std::array<Event, CHUNK_EVENTS> events;
+			std::atomic<size_t> count{0};
+			std::atomic<Chunk*> next{nullptr};
+		};
+
+		struct ThreadBuffer
+		{
+			~ThreadBuffer()
+			{
+				FreeChunks(head);
+			}
+
+			static void FreeChunks(Chunk* chunk)
+			{
+				while (chunk)
+				{
+					delete std::exchange(chunk, chunk->next.load(std::memory_order_relaxed));
+				}
+			}
+
+			int tid = 0;
+			std::atomic<const char*> name{nullptr};
+			std::atomic<uint64_t> generation{0};
+			std::atomic<Chunk*> head{nullptr};
+			Chunk* tail = nullptr;
+			size_t chunks = 0;
+			std::atomic<uint64_t> dropped{0};
+		};
+
+		// Buffers stay after their thread exits so its events can still be exported. The mutex is taken when a thread
+		// records for the first time, when it resets its buffer for a new recording, and by Export.
+		std::mutex buffersMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		std::atomic<uint64_t> generation{1};
+		std::atomic<Clock::rep> epoch{0};
+		thread_local ThreadBuffer* localBuffer = nullptr;
+
+		// Copies of every string recorded, kept until the plugin unloads. The set's nodes don't move, so events
+		// and thread names point into it.
+		std::mutex internMutex;
+		std::unordered_set<std::string> interned;
+
+		// Each thread remembers which copy a pointer it recorded resolved to. The strcmp catches a pointer that now
+		// holds a different string, so recording only takes the lock for strings it hasn't seen.
+		const char* Intern(const char* text)
+		{
+			if (!text)
+			{
+				return nullptr;
+			}
+			thread_local std::unordered_map<const char*, const char*> cache;
+			if (cache.size() > 4096)
+			{
+				cache.clear();
+			}
+			const char*& copy = cache[text];
+			if (!copy || std::strcmp(copy, text) != 0)
+			{
+				std::lock_guard lock(internMutex);
+				copy = interned.emplace(text).first->c_str();
+			}
+			return copy;
+		}
+
+		ThreadBuffer& LocalBuffer()
+		{
+			if (!localBuffer)
+			{
+				std::lock_guard lock(buffersMutex);
+				buffers.push_back(std::make_unique<ThreadBuffer>());
+				localBuffer = buffers.back().get();
+				localBuffer->tid = static_cast<int>(buffers.size());
+			}
+			return *localBuffer;
+		}
+
+		void Append(const Event& event)
+		{
+			ThreadBuffer& buffer = LocalBuffer();
+			const uint64_t current = generation.load(std::memory_order_acquire);
+			if (buffer.generation.load(std::memory_order_relaxed) != current)
+			{
+				// First event of a new recording on this thread
+				std::lock_guard lock(buffersMutex);
+				ThreadBuffer::FreeChunks(buffer.head.exchange(nullptr, std::memory_order_relaxed));
+				buffer.tail = nullptr;
+				buffer.chunks = 0;
+				buffer.dropped.store(0, std::memory_order_relaxed);
+				buffer.generation.store(current, std::memory_order_relaxed);
+			}
+
+			Chunk* tail = buffer.tail;
+			size_t count = tail ? tail->count.load(std::memory_order_relaxed) : CHUNK_EVENTS;
+			if (count == CHUNK_EVENTS)
+			{
+				if (buffer.chunks == MAX_CHUNKS)
+				{
+					buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				auto* chunk = new Chunk;
+				if (tail)
+				{
+					tail->next.store(chunk, std::memory_order_release);
+				}
+				else
+				{
+					buffer.head.store(chunk, std::memory_order_release);
+				}
+				buffer.tail = tail = chunk;
+				++buffer.chunks;
+				count = 0;
+			}
+			tail->events[count] = event;
+			tail->count.store(count + 1, std::memory_order_release);
+		}
+
+		void WriteString(std::string& out, const char* text)
+		{
+			out += '"';
+			for (const char* c = text; *c; ++c)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					out += '\\';
+					out += *c;
+				}
+				else if (static_cast<unsigned char>(*c) < 0x20)
+				{
+					out += std::format("\\u{:04x}", static_cast<int>(*c));
+				}
+				else
+				{
+					out += *c;
+				}
+			}
+			out += '"';
+		}
+
+		// Microseconds with nanosecond decimals, the unit of the trace event format
+		std::string Microseconds(Clock::duration duration)
+		{
+			const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+			return std::format("{}.{:03}", ns / 1000, ns % 1000);
+		}
+	}
+}
+
+namespace tracing
+{
+	using namespace detail;
+
+	void Start()
+	{
+		epoch.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+		generation.fetch_add(1, std::memory_order_release);
+		enabled.store(true, std::memory_order_release);
+	}
+
+	void Stop()
+	{
+		enabled.store(false, std::memory_order_release);
+	}
+
+	void Complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end,
+		const char* arg0, int64_t value0, const char* arg1, int64_t value1)
+	{
+		if (IsEnabled())
+		{
+			Append({Intern(name), Intern(category), {Intern(arg0), Intern(arg1)}, {value0, value1}, start, end - start, Kind::Complete});
+		}
+	}
+
+	void Counter(const char* name, int64_t value)
+	{
+		if (IsEnabled())
+		{
+			Append({Intern(name), "counter", {nullptr, nullptr}, {value, 0}, Clock::now(), {}, Kind::Counter});
+		}
+	}
+
+	void SetThreadName(const char* name)
+	{
+		LocalBuffer().name.store(Intern(name), std::memory_order_relaxed);
+	}
+
+	bool Export(const std::filesystem::path& path)
+	{
+		struct ThreadEvents
+		{
+			int tid;
+			const char* name;
+			uint64_t dropped;
+			std::vector<Event> events;
+		};
+		std::vector<ThreadEvents> threads;
+		{
+			// Copied out quickly, threads that start a new recording meanwhile wait on this lock
+			std::lock_guard lock(buffersMutex);
+			const uint64_t current = generation.load(std::memory_order_acquire);
+			for (const auto& buffer : buffers)
+			{
+				ThreadEvents& thread = threads.emplace_back(ThreadEvents{buffer->tid, buffer->name.load(std::memory_order_relaxed), 0, {}});
+				if (buffer->generation.load(std::memory_order_relaxed) != current)
+				{
+					continue;
+				}
+				thread.dropped = buffer->dropped.load(std::memory_order_relaxed);
+				for (const Chunk* chunk = buffer->head.load(std::memory_order_acquire); chunk; chunk = chunk->next.load(std::memory_order_acquire))
+				{
+					const size_t count = chunk->count.load(std::memory_order_acquire);
+					thread.events.insert(thread.events.end(), chunk->events.begin(), chunk->events.begin() + static_cast<std::ptrdiff_t>(count));
+				}
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		const Clock::time_point start{Clock::duration(epoch.load(std::memory_order_relaxed))};
+		std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		bool first = true;
+		auto separator = [&out, &first]
+		{
+			out += first ? "" : ",\n";
+			first = false;
+		};
+		for (const ThreadEvents& thread : threads)
+		{
+			separator();
+			out += std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", thread.tid);
+			WriteString(out, thread.name ? thread.name : std::format("thread {}", thread.tid).c_str());
+			out += "}}";
+			if (thread.dropped > 0)
+			{
+				WARNLOG("trace buffer of thread {} was full, {} events were dropped", thread.tid, thread.dropped);
+			}
+
+			for (const Event& event : thread.events)
+			{
+				if (event.start < start)
+				{
+					continue;
+				}
+				separator();
+				out += "{\"name\":";
+				WriteString(out, event.name);
+				out += ",\"cat\":";
+				WriteString(out, event.category);
+				if (event.kind == Kind::Complete)
+				{
+					out += std::format(",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{},\"dur\":{}", thread.tid, Microseconds(event.start - start),
+						Microseconds(event.duration));
+					if (event.argNames[0])
+					{
+						out += ",\"args\":{";
+						WriteString(out, event.argNames[0]);
+						out += std::format(":{}", event.args[0]);
+						if (event.argNames[1])
+						{
+							out += ',';
+							WriteString(out, event.argNames[1]);
+							out += std::format(":{}", event.args[1]);
+						}
+						out += '}';
+					}
+				}
+				else
+				{
+					out += std::format(",\"ph\":\"C\",\"pid\":1,\"tid\":{},\"ts\":{},\"args\":{{\"value\":{}}}", thread.tid,
+						Microseconds(event.start - start), event.args[0]);
+				}
+				out += '}';
+			}
+			if (out.size() > (1 << 20))
+			{
+				file.write(out.data(), static_cast<std::streamsize>(out.size()));
+				out.clear();
+			}
+		}
+		out += "\n]}\n";
+		file.write(out.data(), static_cast<std::streamsize>(out.size()));
+		return static_cast<bool>(file);
+	}
+
+	void RegisterNotifier(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name, std::filesystem::path defaultPath)
+	{
+		cvarManager->registerNotifier(name, [defaultPath = std::move(defaultPath)](std::vector<std::string> args)
+		{
+			if (args.size() >= 2 && args[1] == "start")
+			{
+				SetThreadName("game");
+				Start();
+				LOG("Tracing started");
+			}
+			else if (args.size() >= 2 && args[1] == "stop")
+			{
+				Stop();
+				LOG("Tracing stopped");
+			}
+			else if (args.size() >= 2 && args[1] == "export")
+			{
+				const std::filesystem::path path = args.size() >= 3 ? std::filesystem::path(args[2]) : defaultPath;
+				if (Export(path))
+				{
+					LOG("Trace written to {}, open it in chrome://tracing or ui.perfetto.dev", path.string());
+				}
+				else
+				{
+					WARNLOG("Could not write the trace to {}", path.string());
+				}
+			}
+			else
+			{
+				LOG("Tracing is {}. 'start' begins a new recording, 'stop' pauses it, 'export [file]' writes it", IsEnabled() ? "on" : "off");
+			}
+		}, "Records plugin timing zones. 'start', 'stop', 'export [file]' for chrome://tracing or ui.perfetto.dev", PERMISSION_ALL);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Session traces in the Chrome trace event format, for chrome://tracing or https://ui.perfetto.dev.
+// Every thread records zones and counters into its own buffer without taking a lock, Export merges them into one
+// JSON file with thread names, nesting and counter values intact. Nothing is recorded until Start().
+//
+// Hooks registered through a HookProfiler, JobSystem jobs, GUI zones and log flushes record themselves.
+// Names are copied the first time a thread records them, so they can come from strings that go away before the export.
+namespace tracing
+{
+	using Clock = std::chrono::steady_clock;
+
+	namespace detail
+	{
+		extern std::atomic<bool> enabled;
+	}
+
+	// Starts a new recording, the previous one is dropped
+	void Start();
+	void Stop();
+	[[nodiscard]] inline bool IsEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+	// A zone that was timed elsewhere, with up to two integer args shown when it is selected
+	void Complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end,
+		const char* arg0 = nullptr, int64_t value0 = 0, const char* arg1 = nullptr, int64_t value1 = 0);
+	void Counter(const char* name, int64_t value);
+	// How the calling thread is labelled in the trace
+	void SetThreadName(const char* name);
+
+	bool Export(const std::filesystem::path& path);
+	// `name start`, `name stop`, `name export [file]`
+	void RegisterNotifier(const std::shared_ptr<CVarManagerWrapper>& cvarManager, const std::string& name, std::filesystem::path defaultPath);
+
+	// Records the enclosing scope, costs one relaxed load while tracing is off
+	class Zone
+	{
+	public:
+		explicit Zone(const char* name, const char* category = "plugin")
+			: name_(name), category_(category), start_(IsEnabled() ? Clock::now() : Clock::time_point())
+		{
+		}
+
+		~Zone()
+		{
+			if (start_ != Clock::time_point())
+			{
+				Complete(name_, category_, start_, Clock::now());
+			}
+		}
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		const char* name_;
+		const char* category_;
+		Clock::time_point start_;
+	};
+}
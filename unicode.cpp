@@ -0,0 +1,298 @@
+#include "pch.h"
+#include "unicode.h"
+
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#define UNICODE_SIMD 1
+#else
+#define UNICODE_SIMD 0
+#endif
+
+namespace unicode
+{
+	namespace
+	{
+		constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+		constexpr bool UTF16_WCHAR = sizeof(wchar_t) == 2;
+
+		char* EncodeUtf8(uint32_t cp, char* dst)
+		{
+			if (cp < 0x80)
+			{
+				*dst++ = static_cast<char>(cp);
+			}
+			else if (cp < 0x800)
+			{
+				*dst++ = static_cast<char>(0xC0 | (cp >> 6));
+				*dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+			}
+			else if (cp < 0x10000)
+			{
+				*dst++ = static_cast<char>(0xE0 | (cp >> 12));
+				*dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+				*dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+			}
+			else
+			{
+				*dst++ = static_cast<char>(0xF0 | (cp >> 18));
+				*dst++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+				*dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+				*dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+			}
+			return dst;
+		}
+
+		wchar_t* EncodeWide(uint32_t cp, wchar_t* dst)
+		{
+			if (UTF16_WCHAR && cp >= 0x10000)
+			{
+				cp -= 0x10000;
+				*dst++ = static_cast<wchar_t>(0xD800 | (cp >> 10));
+				*dst++ = static_cast<wchar_t>(0xDC00 | (cp & 0x3FF));
+			}
+			else
+			{
+				*dst++ = static_cast<wchar_t>(cp);
+			}
+			return dst;
+		}
+
+		// Copies ASCII while there is a full block of it, returns how many code units were converted.
+		size_t WidenAsciiBlock(const wchar_t* src, size_t count, char* dst)
+		{
+			size_t done = 0;
+#if UNICODE_SIMD
+			if constexpr (UTF16_WCHAR)
+			{
+#ifdef __AVX2__
+				const __m256i mask256 = _mm256_set1_epi16(static_cast<short>(0xFF80));
+				while (count - done >= 32)
+				{
+					const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + done));
+					const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + done + 16));
+					if (!_mm256_testz_si256(_mm256_or_si256(a, b), mask256))
+					{
+						break;
+					}
+					// packus works per 128 bit lane, put the quadwords back in order
+					const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + done), packed);
+					done += 32;
+				}
+#endif
+				const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+				while (count - done >= 16)
+				{
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + done));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + done + 8));
+					const __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+					if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF)
+					{
+						break;
+					}
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + done), _mm_packus_epi16(a, b));
+					done += 16;
+				}
+			}
+			else
+			{
+				// 32 bit wchar_t (Linux builds of the benchmarks)
+				const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+				while (count - done >= 16)
+				{
+					const auto* block = reinterpret_cast<const __m128i*>(src + done);
+					const __m128i a = _mm_loadu_si128(block);
+					const __m128i b = _mm_loadu_si128(block + 1);
+					const __m128i c = _mm_loadu_si128(block + 2);
+					const __m128i d = _mm_loadu_si128(block + 3);
+					const __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+					if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+					{
+						break;
+					}
+					const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + done), packed);
+					done += 16;
+				}
+			}
+#endif
+			return done;
+		}
+
+		size_t NarrowAsciiBlock(const char* src, size_t count, wchar_t* dst)
+		{
+			size_t done = 0;
+#if UNICODE_SIMD
+			if constexpr (UTF16_WCHAR)
+			{
+				while (count - done >= 16)
+				{
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + done));
+					if (_mm_movemask_epi8(bytes) != 0)
+					{
+						break;
+					}
+					const __m128i zero = _mm_setzero_si128();
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + done), _mm_unpacklo_epi8(bytes, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + done + 8), _mm_unpackhi_epi8(bytes, zero));
+					done += 16;
+				}
+			}
+			else
+			{
+				while (count - done >= 16)
+				{
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + done));
+					if (_mm_movemask_epi8(bytes) != 0)
+					{
+						break;
+					}
+					const __m128i zero = _mm_setzero_si128();
+					const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+					const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+					auto* out = reinterpret_cast<__m128i*>(dst + done);
+					_mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+					_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+					_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+					_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+					done += 16;
+				}
+			}
+#endif
+			return done;
+		}
+	}
+
+	void AppendUtf8(std::wstring_view utf16, std::string& out)
+	{
+		// A UTF-16 code unit never needs more than 3 bytes (surrogate pairs need 4 for 2 units)
+		const size_t start = out.size();
+		out.resize(start + utf16.size() * (UTF16_WCHAR ? 3 : 4));
+
+		char* dst = out.data() + start;
+		const wchar_t* src = utf16.data();
+		const wchar_t* end = src + utf16.size();
+		while (src < end)
+		{
+			if (static_cast<uint32_t>(*src) < 0x80)
+			{
+				const size_t ascii = WidenAsciiBlock(src, end - src, dst);
+				if (ascii != 0)
+				{
+					src += ascii;
+					dst += ascii;
+					continue;
+				}
+				*dst++ = static_cast<char>(*src++);
+				continue;
+			}
+
+			uint32_t cp = static_cast<uint32_t>(*src++);
+			if constexpr (UTF16_WCHAR)
+			{
+				if (cp >= 0xD800 && cp < 0xDC00 && src < end && *src >= 0xDC00 && *src < 0xE000)
+				{
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<uint32_t>(*src++) - 0xDC00);
+				}
+				else if (cp >= 0xD800 && cp < 0xE000)
+				{
+					cp = REPLACEMENT_CHARACTER;
+				}
+			}
+			else if (cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+			{
+				cp = REPLACEMENT_CHARACTER;
+			}
+			dst = EncodeUtf8(cp, dst);
+		}
+		out.resize(dst - out.data());
+	}
+
+	std::string ToUtf8(std::wstring_view utf16)
+	{
+		std::string out;
+		AppendUtf8(utf16, out);
+		return out;
+	}
+
+	void AppendUtf16(std::string_view utf8, std::wstring& out)
+	{
+		// Never more code units than bytes
+		const size_t start = out.size();
+		out.resize(start + utf8.size());
+
+		wchar_t* dst = out.data() + start;
+		const auto* src = reinterpret_cast<const unsigned char*>(utf8.data());
+		const auto* end = src + utf8.size();
+		while (src < end)
+		{
+			if (*src < 0x80)
+			{
+				const size_t ascii = NarrowAsciiBlock(reinterpret_cast<const char*>(src), end - src, dst);
+				if (ascii != 0)
+				{
+					src += ascii;
+					dst += ascii;
+					continue;
+				}
+				*dst++ = static_cast<wchar_t>(*src++);
+				continue;
+			}
+
+			const unsigned char lead = *src;
+			size_t length;
+			uint32_t cp;
+			uint32_t min;
+			if ((lead & 0xE0) == 0xC0)
+			{
+				length = 2;
+				cp = lead & 0x1F;
+				min = 0x80;
+			}
+			else if ((lead & 0xF0) == 0xE0)
+			{
+				length = 3;
+				cp = lead & 0x0F;
+				min = 0x800;
+			}
+			else if ((lead & 0xF8) == 0xF0)
+			{
+				length = 4;
+				cp = lead & 0x07;
+				min = 0x10000;
+			}
+			else
+			{
+				++src;
+				dst = EncodeWide(REPLACEMENT_CHARACTER, dst);
+				continue;
+			}
+
+			bool valid = static_cast<size_t>(end - src) >= length;
+			for (size_t i = 1; valid && i < length; ++i)
+			{
+				valid = (src[i] & 0xC0) == 0x80;
+				cp = (cp << 6) | (src[i] & 0x3F);
+			}
+			// Overlong forms, surrogates and anything past U+10FFFF are invalid too
+			if (!valid || cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+			{
+				++src;
+				dst = EncodeWide(REPLACEMENT_CHARACTER, dst);
+				continue;
+			}
+			src += length;
+			dst = EncodeWide(cp, dst);
+		}
+		out.resize(dst - out.data());
+	}
+
+	std::wstring ToUtf16(std::string_view utf8)
+	{
+		std::wstring out;
+		AppendUtf16(utf8, out);
+		return out;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// UTF-16 <-> UTF-8 conversion for the wide logging overloads and anything else that hands wide strings
+// (player names, file paths) to the narrow SDK functions. Runs of ASCII are converted 16 characters at a time.
+namespace unicode
+{
+	// Unpaired surrogates are replaced with U+FFFD.
+	void AppendUtf8(std::wstring_view utf16, std::string& out);
+	[[nodiscard]] std::string ToUtf8(std::wstring_view utf16);
+
+	// Invalid or truncated sequences are replaced with U+FFFD.
+	void AppendUtf16(std::string_view utf8, std::wstring& out);
+	[[nodiscard]] std::wstring ToUtf16(std::string_view utf8);
+}